@@ -80,10 +80,10 @@ struct FrameResources
 {
     WGPUBuffer  IndexBuffer;
     WGPUBuffer  VertexBuffer;
-    ImDrawIdx*  IndexBufferHost;
-    ImDrawVert* VertexBufferHost;
     int         IndexBufferSize;
     int         VertexBufferSize;
+    int         IndexBufferUnderuseFrames;  // Consecutive frames the buffer was mostly empty
+    int         VertexBufferUnderuseFrames;
 };
 
 struct Uniforms
@@ -172,18 +172,6 @@ fn main(in: VertexOutput) -> @location(0) vec4<f32> {
 }
 )";
 
-static void SafeRelease(ImDrawIdx*& res)
-{
-    if (res)
-        delete[] res;
-    res = nullptr;
-}
-static void SafeRelease(ImDrawVert*& res)
-{
-    if (res)
-        delete[] res;
-    res = nullptr;
-}
 static void SafeRelease(WGPUBindGroupLayout& res)
 {
     if (res)
@@ -239,10 +227,9 @@ static void SafeRelease(WGPUTexture& res)
     res = nullptr;
 }
 
+// The font texture is not included: it survives device object invalidation (see ImGui_ImplWGPU_DestroyFontsTexture)
 static void SafeRelease(RenderResources& res)
 {
-    SafeRelease(res.FontTexture);
-    SafeRelease(res.FontTextureView);
     SafeRelease(res.Sampler);
     SafeRelease(res.Uniforms);
     SafeRelease(res.CommonBindGroup);
@@ -254,8 +241,6 @@ static void SafeRelease(FrameResources& res)
 {
     SafeRelease(res.IndexBuffer);
     SafeRelease(res.VertexBuffer);
-    SafeRelease(res.IndexBufferHost);
-    SafeRelease(res.VertexBufferHost);
 }
 
 static WGPUProgrammableStageDescriptor ImGui_ImplWGPU_CreateShaderModule(const char* wgsl_source)
@@ -359,6 +344,59 @@ static void ImGui_ImplWGPU_SetupRenderState(ImDrawData* draw_data, WGPURenderPas
     wgpuRenderPassEncoderSetBlendConstant(ctx, &blend_color);
 }
 
+// Index count rounded up so the next draw list's indices start on a 4-byte boundary
+static inline int ImGui_ImplWGPU_AlignedIdxCount(int count)
+{
+    return (int)(MEMALIGN(count * sizeof(ImDrawIdx), 4) / sizeof(ImDrawIdx));
+}
+
+// Buffers grow geometrically and only shrink after being mostly empty for ShrinkAfterFrames consecutive frames,
+// so a UI whose size oscillates doesn't reallocate every few frames. Returns false if the buffer couldn't be created.
+static bool ImGui_ImplWGPU_UpdateBufferCapacity(WGPUBuffer& buffer, int& capacity, int& underuse_frames, int required, int min_capacity, size_t element_size, WGPUBufferUsageFlags usage, const char* label)
+{
+    const int ShrinkAfterFrames = 120;
+    int new_capacity = capacity;
+    if (required > capacity)
+    {
+        while (new_capacity < required)
+            new_capacity *= 2;
+        underuse_frames = 0;
+    }
+    else if (required < capacity / 4 && capacity > min_capacity)
+    {
+        if (++underuse_frames >= ShrinkAfterFrames)
+        {
+            new_capacity = required * 2 > min_capacity ? required * 2 : min_capacity;
+            underuse_frames = 0;
+        }
+    }
+    else
+    {
+        underuse_frames = 0;
+    }
+
+    if (buffer != nullptr && new_capacity == capacity)
+        return true;
+
+    if (buffer)
+    {
+        wgpuBufferDestroy(buffer);
+        wgpuBufferRelease(buffer);
+    }
+    capacity = new_capacity;
+
+    WGPUBufferDescriptor desc =
+    {
+        nullptr,
+        label,
+        usage,
+        MEMALIGN(capacity * element_size, 4),
+        false
+    };
+    buffer = wgpuDeviceCreateBuffer(ImGui_ImplWGPU_GetBackendData()->wgpuDevice, &desc);
+    return buffer != nullptr;
+}
+
 // Render function
 // (this used to be set in io.RenderDrawListsFn and called by ImGui::Render(), but you can now call this directly from your main loop)
 void ImGui_ImplWGPU_RenderDrawData(ImDrawData* draw_data, WGPURenderPassEncoder pass_encoder)
@@ -375,72 +413,42 @@ void ImGui_ImplWGPU_RenderDrawData(ImDrawData* draw_data, WGPURenderPassEncoder
     bd->frameIndex = bd->frameIndex + 1;
     FrameResources* fr = &bd->pFrameResources[bd->frameIndex % bd->numFramesInFlight];
 
-    // Create and grow vertex/index buffers if needed
-    if (fr->VertexBuffer == nullptr || fr->VertexBufferSize < draw_data->TotalVtxCount)
-    {
-        if (fr->VertexBuffer)
-        {
-            wgpuBufferDestroy(fr->VertexBuffer);
-            wgpuBufferRelease(fr->VertexBuffer);
-        }
-        SafeRelease(fr->VertexBufferHost);
-        fr->VertexBufferSize = draw_data->TotalVtxCount + 5000;
-
-        WGPUBufferDescriptor vb_desc =
-        {
-            nullptr,
-            "Dear ImGui Vertex buffer",
-            WGPUBufferUsage_CopyDst | WGPUBufferUsage_Vertex,
-            MEMALIGN(fr->VertexBufferSize * sizeof(ImDrawVert), 4),
-            false
-        };
-        fr->VertexBuffer = wgpuDeviceCreateBuffer(bd->wgpuDevice, &vb_desc);
-        if (!fr->VertexBuffer)
-            return;
+    // Create, grow or shrink vertex/index buffers if needed.
+    // Each draw list's indices are padded to 4 bytes, so reserve room for that too.
+    if (!ImGui_ImplWGPU_UpdateBufferCapacity(fr->VertexBuffer, fr->VertexBufferSize, fr->VertexBufferUnderuseFrames,
+            draw_data->TotalVtxCount, 5000, sizeof(ImDrawVert), WGPUBufferUsage_CopyDst | WGPUBufferUsage_Vertex, "Dear ImGui Vertex buffer"))
+        return;
+    if (!ImGui_ImplWGPU_UpdateBufferCapacity(fr->IndexBuffer, fr->IndexBufferSize, fr->IndexBufferUnderuseFrames,
+            draw_data->TotalIdxCount + draw_data->CmdListsCount, 10000, sizeof(ImDrawIdx), WGPUBufferUsage_CopyDst | WGPUBufferUsage_Index, "Dear ImGui Index buffer"))
+        return;
 
-        fr->VertexBufferHost = new ImDrawVert[fr->VertexBufferSize];
-    }
-    if (fr->IndexBuffer == nullptr || fr->IndexBufferSize < draw_data->TotalIdxCount)
+    // Write each draw list straight from its own storage into the GPU buffers, without an intermediate host copy.
+    // wgpuQueueWriteBuffer() needs 4-byte aligned offsets and sizes: vertices always are, and an odd count of
+    // 16-bit indices gets its last index written from a padded temporary.
+    static_assert(sizeof(ImDrawVert) % 4 == 0, "ImDrawVert must be a multiple of 4 bytes");
+    uint64_t vtx_write_offset = 0;
+    uint64_t idx_write_offset = 0;
+    for (int n = 0; n < draw_data->CmdListsCount; n++)
     {
-        if (fr->IndexBuffer)
+        const ImDrawList* draw_list = draw_data->CmdLists[n];
+        uint64_t vtx_size = (uint64_t)draw_list->VtxBuffer.Size * sizeof(ImDrawVert);
+        uint64_t idx_size = (uint64_t)draw_list->IdxBuffer.Size * sizeof(ImDrawIdx);
+        if (vtx_size > 0)
+            wgpuQueueWriteBuffer(bd->defaultQueue, fr->VertexBuffer, vtx_write_offset, draw_list->VtxBuffer.Data, vtx_size);
+
+        uint64_t idx_body_size = idx_size & ~(uint64_t)3;
+        if (idx_body_size > 0)
+            wgpuQueueWriteBuffer(bd->defaultQueue, fr->IndexBuffer, idx_write_offset, draw_list->IdxBuffer.Data, idx_body_size);
+        if (idx_size > idx_body_size)
         {
-            wgpuBufferDestroy(fr->IndexBuffer);
-            wgpuBufferRelease(fr->IndexBuffer);
+            ImDrawIdx tail[2] = { draw_list->IdxBuffer.Data[draw_list->IdxBuffer.Size - 1], 0 };
+            wgpuQueueWriteBuffer(bd->defaultQueue, fr->IndexBuffer, idx_write_offset + idx_body_size, tail, 4);
         }
-        SafeRelease(fr->IndexBufferHost);
-        fr->IndexBufferSize = draw_data->TotalIdxCount + 10000;
 
-        WGPUBufferDescriptor ib_desc =
-        {
-            nullptr,
-            "Dear ImGui Index buffer",
-            WGPUBufferUsage_CopyDst | WGPUBufferUsage_Index,
-            MEMALIGN(fr->IndexBufferSize * sizeof(ImDrawIdx), 4),
-            false
-        };
-        fr->IndexBuffer = wgpuDeviceCreateBuffer(bd->wgpuDevice, &ib_desc);
-        if (!fr->IndexBuffer)
-            return;
-
-        fr->IndexBufferHost = new ImDrawIdx[fr->IndexBufferSize];
+        vtx_write_offset += vtx_size;
+        idx_write_offset += MEMALIGN(idx_size, 4);
     }
 
-    // Upload vertex/index data into a single contiguous GPU buffer
-    ImDrawVert* vtx_dst = (ImDrawVert*)fr->VertexBufferHost;
-    ImDrawIdx* idx_dst = (ImDrawIdx*)fr->IndexBufferHost;
-    for (int n = 0; n < draw_data->CmdListsCount; n++)
-    {
-        const ImDrawList* draw_list = draw_data->CmdLists[n];
-        memcpy(vtx_dst, draw_list->VtxBuffer.Data, draw_list->VtxBuffer.Size * sizeof(ImDrawVert));
-        memcpy(idx_dst, draw_list->IdxBuffer.Data, draw_list->IdxBuffer.Size * sizeof(ImDrawIdx));
-        vtx_dst += draw_list->VtxBuffer.Size;
-        idx_dst += draw_list->IdxBuffer.Size;
-    }
-    int64_t vb_write_size = MEMALIGN((char*)vtx_dst - (char*)fr->VertexBufferHost, 4);
-    int64_t ib_write_size = MEMALIGN((char*)idx_dst - (char*)fr->IndexBufferHost, 4);
-    wgpuQueueWriteBuffer(bd->defaultQueue, fr->VertexBuffer, 0, fr->VertexBufferHost, vb_write_size);
-    wgpuQueueWriteBuffer(bd->defaultQueue, fr->IndexBuffer,  0, fr->IndexBufferHost,  ib_write_size);
-
     // Setup desired render state
     ImGui_ImplWGPU_SetupRenderState(draw_data, pass_encoder, fr);
 
@@ -453,10 +461,29 @@ void ImGui_ImplWGPU_RenderDrawData(ImDrawData* draw_data, WGPURenderPassEncoder
 
     // Render command lists
     // (Because we merged all buffers into a single one, we maintain our own offset into them)
+    // Bind group and scissor are only set when they differ from the previous command, and consecutive
+    // commands sharing both with contiguous indices are merged into a single draw call.
     int global_vtx_offset = 0;
     int global_idx_offset = 0;
     ImVec2 clip_scale = draw_data->FramebufferScale;
     ImVec2 clip_off = draw_data->DisplayPos;
+
+    bool state_known = false;           // False until set, and after any callback that may have changed it
+    ImTextureID last_tex_id = (ImTextureID)0;
+    WGPUBindGroup last_bind_group = nullptr;
+    uint32_t last_scissor[4] = {};
+
+    uint32_t pending_first_index = 0;   // Draw being accumulated, issued when the state changes
+    uint32_t pending_index_count = 0;
+    int32_t pending_base_vertex = 0;
+    auto flush_pending_draw = [&]()
+    {
+        if (pending_index_count == 0)
+            return;
+        wgpuRenderPassEncoderDrawIndexed(pass_encoder, pending_index_count, 1, pending_first_index, pending_base_vertex, 0);
+        pending_index_count = 0;
+    };
+
     for (int n = 0; n < draw_data->CmdListsCount; n++)
     {
         const ImDrawList* draw_list = draw_data->CmdLists[n];
@@ -467,28 +494,15 @@ void ImGui_ImplWGPU_RenderDrawData(ImDrawData* draw_data, WGPURenderPassEncoder
             {
                 // User callback, registered via ImDrawList::AddCallback()
                 // (ImDrawCallback_ResetRenderState is a special callback value used by the user to request the renderer to reset render state.)
+                flush_pending_draw();
                 if (pcmd->UserCallback == ImDrawCallback_ResetRenderState)
                     ImGui_ImplWGPU_SetupRenderState(draw_data, pass_encoder, fr);
                 else
                     pcmd->UserCallback(draw_list, pcmd);
+                state_known = false;
             }
             else
             {
-                // Bind custom texture
-                ImTextureID tex_id = pcmd->GetTexID();
-                ImGuiID tex_id_hash = ImHashData(&tex_id, sizeof(tex_id));
-                auto bind_group = bd->renderResources.ImageBindGroups.GetVoidPtr(tex_id_hash);
-                if (bind_group)
-                {
-                    wgpuRenderPassEncoderSetBindGroup(pass_encoder, 1, (WGPUBindGroup)bind_group, 0, nullptr);
-                }
-                else
-                {
-                    WGPUBindGroup image_bind_group = ImGui_ImplWGPU_CreateImageBindGroup(bd->renderResources.ImageBindGroupLayout, (WGPUTextureView)tex_id);
-                    bd->renderResources.ImageBindGroups.SetVoidPtr(tex_id_hash, image_bind_group);
-                    wgpuRenderPassEncoderSetBindGroup(pass_encoder, 1, image_bind_group, 0, nullptr);
-                }
-
                 // Project scissor/clipping rectangles into framebuffer space
                 ImVec2 clip_min((pcmd->ClipRect.x - clip_off.x) * clip_scale.x, (pcmd->ClipRect.y - clip_off.y) * clip_scale.y);
                 ImVec2 clip_max((pcmd->ClipRect.z - clip_off.x) * clip_scale.x, (pcmd->ClipRect.w - clip_off.y) * clip_scale.y);
@@ -500,65 +514,108 @@ void ImGui_ImplWGPU_RenderDrawData(ImDrawData* draw_data, WGPURenderPassEncoder
                 if (clip_max.y > fb_height) { clip_max.y = (float)fb_height; }
                 if (clip_max.x <= clip_min.x || clip_max.y <= clip_min.y)
                     continue;
+                uint32_t scissor[4] = { (uint32_t)clip_min.x, (uint32_t)clip_min.y, (uint32_t)(clip_max.x - clip_min.x), (uint32_t)(clip_max.y - clip_min.y) };
+
+                // Look up the texture's bind group only when the texture changes
+                ImTextureID tex_id = pcmd->GetTexID();
+                WGPUBindGroup bind_group = last_bind_group;
+                if (!state_known || tex_id != last_tex_id)
+                {
+                    ImGuiID tex_id_hash = ImHashData(&tex_id, sizeof(tex_id));
+                    bind_group = (WGPUBindGroup)bd->renderResources.ImageBindGroups.GetVoidPtr(tex_id_hash);
+                    if (!bind_group)
+                    {
+                        bind_group = ImGui_ImplWGPU_CreateImageBindGroup(bd->renderResources.ImageBindGroupLayout, (WGPUTextureView)tex_id);
+                        bd->renderResources.ImageBindGroups.SetVoidPtr(tex_id_hash, bind_group);
+                    }
+                }
+                bool bind_group_changed = !state_known || bind_group != last_bind_group;
+                bool scissor_changed = !state_known || memcmp(scissor, last_scissor, sizeof(scissor)) != 0;
+
+                // Extend the pending draw when nothing changed and the indices continue where it ends
+                uint32_t first_index = pcmd->IdxOffset + global_idx_offset;
+                int32_t base_vertex = (int32_t)(pcmd->VtxOffset + global_vtx_offset);
+                if (!bind_group_changed && !scissor_changed && pending_index_count > 0 &&
+                    base_vertex == pending_base_vertex && first_index == pending_first_index + pending_index_count)
+                {
+                    pending_index_count += pcmd->ElemCount;
+                    continue;
+                }
 
-                // Apply scissor/clipping rectangle, Draw
-                wgpuRenderPassEncoderSetScissorRect(pass_encoder, (uint32_t)clip_min.x, (uint32_t)clip_min.y, (uint32_t)(clip_max.x - clip_min.x), (uint32_t)(clip_max.y - clip_min.y));
-                wgpuRenderPassEncoderDrawIndexed(pass_encoder, pcmd->ElemCount, 1, pcmd->IdxOffset + global_idx_offset, pcmd->VtxOffset + global_vtx_offset, 0);
+                flush_pending_draw();
+                if (bind_group_changed)
+                    wgpuRenderPassEncoderSetBindGroup(pass_encoder, 1, bind_group, 0, nullptr);
+                if (scissor_changed)
+                    wgpuRenderPassEncoderSetScissorRect(pass_encoder, scissor[0], scissor[1], scissor[2], scissor[3]);
+                state_known = true;
+                last_tex_id = tex_id;
+                last_bind_group = bind_group;
+                memcpy(last_scissor, scissor, sizeof(scissor));
+
+                pending_first_index = first_index;
+                pending_index_count = pcmd->ElemCount;
+                pending_base_vertex = base_vertex;
             }
         }
-        global_idx_offset += draw_list->IdxBuffer.Size;
+        global_idx_offset += ImGui_ImplWGPU_AlignedIdxCount(draw_list->IdxBuffer.Size);
         global_vtx_offset += draw_list->VtxBuffer.Size;
     }
+    flush_pending_draw();
     platform_io.Renderer_RenderState = NULL;
 }
 
 static void ImGui_ImplWGPU_CreateFontsTexture()
 {
-    // Build texture atlas
     ImGui_ImplWGPU_Data* bd = ImGui_ImplWGPU_GetBackendData();
     ImGuiIO& io = ImGui::GetIO();
-    unsigned char* pixels;
-    int width, height, size_pp;
-    io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height, &size_pp);
 
-    // Upload texture to graphics system
+    // The texture is kept across ImGui_ImplWGPU_InvalidateDeviceObjects(), only build and upload it once
+    if (!bd->renderResources.FontTexture)
     {
-        WGPUTextureDescriptor tex_desc = {};
-        tex_desc.label = "Dear ImGui Font Texture";
-        tex_desc.dimension = WGPUTextureDimension_2D;
-        tex_desc.size.width = width;
-        tex_desc.size.height = height;
-        tex_desc.size.depthOrArrayLayers = 1;
-        tex_desc.sampleCount = 1;
-        tex_desc.format = WGPUTextureFormat_RGBA8Unorm;
-        tex_desc.mipLevelCount = 1;
-        tex_desc.usage = WGPUTextureUsage_CopyDst | WGPUTextureUsage_TextureBinding;
-        bd->renderResources.FontTexture = wgpuDeviceCreateTexture(bd->wgpuDevice, &tex_desc);
-
-        WGPUTextureViewDescriptor tex_view_desc = {};
-        tex_view_desc.format = WGPUTextureFormat_RGBA8Unorm;
-        tex_view_desc.dimension = WGPUTextureViewDimension_2D;
-        tex_view_desc.baseMipLevel = 0;
-        tex_view_desc.mipLevelCount = 1;
-        tex_view_desc.baseArrayLayer = 0;
-        tex_view_desc.arrayLayerCount = 1;
-        tex_view_desc.aspect = WGPUTextureAspect_All;
-        bd->renderResources.FontTextureView = wgpuTextureCreateView(bd->renderResources.FontTexture, &tex_view_desc);
-    }
+        // Build texture atlas
+        unsigned char* pixels;
+        int width, height, size_pp;
+        io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height, &size_pp);
 
-    // Upload texture data
-    {
-        WGPUImageCopyTexture dst_view = {};
-        dst_view.texture = bd->renderResources.FontTexture;
-        dst_view.mipLevel = 0;
-        dst_view.origin = { 0, 0, 0 };
-        dst_view.aspect = WGPUTextureAspect_All;
-        WGPUTextureDataLayout layout = {};
-        layout.offset = 0;
-        layout.bytesPerRow = width * size_pp;
-        layout.rowsPerImage = height;
-        WGPUExtent3D size = { (uint32_t)width, (uint32_t)height, 1 };
-        wgpuQueueWriteTexture(bd->defaultQueue, &dst_view, pixels, (uint32_t)(width * size_pp * height), &layout, &size);
+        // Upload texture to graphics system
+        {
+            WGPUTextureDescriptor tex_desc = {};
+            tex_desc.label = "Dear ImGui Font Texture";
+            tex_desc.dimension = WGPUTextureDimension_2D;
+            tex_desc.size.width = width;
+            tex_desc.size.height = height;
+            tex_desc.size.depthOrArrayLayers = 1;
+            tex_desc.sampleCount = 1;
+            tex_desc.format = WGPUTextureFormat_RGBA8Unorm;
+            tex_desc.mipLevelCount = 1;
+            tex_desc.usage = WGPUTextureUsage_CopyDst | WGPUTextureUsage_TextureBinding;
+            bd->renderResources.FontTexture = wgpuDeviceCreateTexture(bd->wgpuDevice, &tex_desc);
+
+            WGPUTextureViewDescriptor tex_view_desc = {};
+            tex_view_desc.format = WGPUTextureFormat_RGBA8Unorm;
+            tex_view_desc.dimension = WGPUTextureViewDimension_2D;
+            tex_view_desc.baseMipLevel = 0;
+            tex_view_desc.mipLevelCount = 1;
+            tex_view_desc.baseArrayLayer = 0;
+            tex_view_desc.arrayLayerCount = 1;
+            tex_view_desc.aspect = WGPUTextureAspect_All;
+            bd->renderResources.FontTextureView = wgpuTextureCreateView(bd->renderResources.FontTexture, &tex_view_desc);
+        }
+
+        // Upload texture data
+        {
+            WGPUImageCopyTexture dst_view = {};
+            dst_view.texture = bd->renderResources.FontTexture;
+            dst_view.mipLevel = 0;
+            dst_view.origin = { 0, 0, 0 };
+            dst_view.aspect = WGPUTextureAspect_All;
+            WGPUTextureDataLayout layout = {};
+            layout.offset = 0;
+            layout.bytesPerRow = width * size_pp;
+            layout.rowsPerImage = height;
+            WGPUExtent3D size = { (uint32_t)width, (uint32_t)height, 1 };
+            wgpuQueueWriteTexture(bd->defaultQueue, &dst_view, pixels, (uint32_t)(width * size_pp * height), &layout, &size);
+        }
     }
 
     // Create the associated sampler
@@ -750,13 +807,20 @@ void ImGui_ImplWGPU_InvalidateDeviceObjects()
     SafeRelease(bd->pipelineState);
     SafeRelease(bd->renderResources);
 
-    ImGuiIO& io = ImGui::GetIO();
-    io.Fonts->SetTexID(0); // We copied g_pFontTextureView to io.Fonts->TexID so let's clear that as well.
-
     for (unsigned int i = 0; i < bd->numFramesInFlight; i++)
         SafeRelease(bd->pFrameResources[i]);
 }
 
+void ImGui_ImplWGPU_DestroyFontsTexture()
+{
+    ImGui_ImplWGPU_Data* bd = ImGui_ImplWGPU_GetBackendData();
+    SafeRelease(bd->renderResources.FontTexture);
+    SafeRelease(bd->renderResources.FontTextureView);
+
+    ImGuiIO& io = ImGui::GetIO();
+    io.Fonts->SetTexID(0); // We copied g_pFontTextureView to io.Fonts->TexID so let's clear that as well.
+}
+
 bool ImGui_ImplWGPU_Init(ImGui_ImplWGPU_InitInfo* init_info)
 {
     ImGuiIO& io = ImGui::GetIO();
@@ -801,10 +865,10 @@ bool ImGui_ImplWGPU_Init(ImGui_ImplWGPU_InitInfo* init_info)
         FrameResources* fr = &bd->pFrameResources[i];
         fr->IndexBuffer = nullptr;
         fr->VertexBuffer = nullptr;
-        fr->IndexBufferHost = nullptr;
-        fr->VertexBufferHost = nullptr;
         fr->IndexBufferSize = 10000;
         fr->VertexBufferSize = 5000;
+        fr->IndexBufferUnderuseFrames = 0;
+        fr->VertexBufferUnderuseFrames = 0;
     }
 
     return true;
@@ -817,6 +881,7 @@ void ImGui_ImplWGPU_Shutdown()
     ImGuiIO& io = ImGui::GetIO();
 
     ImGui_ImplWGPU_InvalidateDeviceObjects();
+    ImGui_ImplWGPU_DestroyFontsTexture();
     delete[] bd->pFrameResources;
     bd->pFrameResources = nullptr;
     wgpuQueueRelease(bd->defaultQueue);
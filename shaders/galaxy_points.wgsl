@@ -0,0 +1,54 @@
+struct Uniforms {
+    viewProj: mat4x4<f32>,
+}
+@binding(0) @group(0) var<uniform> uniforms: Uniforms;
+
+struct GalaxyInstance {
+    model: mat4x4<f32>,
+    tint: vec4f,
+    phase: f32,  // Orbital phase offset in radians, spins the shared particles about local Y
+}
+@binding(1) @group(0) var<storage, read> instances: array<GalaxyInstance>;
+
+struct VertexInput {
+    @location(0) position: vec3f,
+    @location(1) ellipse: u32,
+};
+
+const INACTIVE_POINT: u32 = 0xffffffffu;
+
+struct VertexOutput {
+    @builtin(position) position: vec4f,
+    @location(0) color: vec4f,
+};
+
+@vertex
+fn vs_main(in: VertexInput, @builtin(instance_index) instanceIndex: u32) -> VertexOutput {
+    let galaxy = instances[instanceIndex];
+
+    let c = cos(galaxy.phase);
+    let s = sin(galaxy.phase);
+    let localPos = vec3f(
+        c * in.position.x - s * in.position.z,
+        in.position.y,
+        s * in.position.x + c * in.position.z
+    );
+
+    var out: VertexOutput;
+    if (in.ellipse == INACTIVE_POINT) {
+        // Unused ellipse slot: place it outside the clip volume
+        out.position = vec4f(2.0, 2.0, 2.0, 1.0);
+        out.color = vec4f(0.0);
+        return out;
+    }
+
+    let worldPos = galaxy.model * vec4f(localPos, 1.0);
+    out.position = uniforms.viewProj * worldPos;
+    out.color = galaxy.tint;
+    return out;
+}
+
+@fragment
+fn fs_main(@location(0) color: vec4f) -> @location(0) vec4f {
+    return color;
+}
@@ -0,0 +1,190 @@
+// Reduces the particle buffers to a few hundred bytes of statistics in two passes.
+// reduce_partials folds a grid-strided slice of points per workgroup through a shared-memory
+// tree into one Partial; reduce_final folds all partials the same way into result.
+
+struct Point {
+    @align(16) position: vec3f,
+    ellipse: u32,
+    @align(16) velocity: vec3f,
+}
+
+const WORKGROUP_SIZE: u32 = 128u;
+const HISTOGRAM_BINS: u32 = 32u;
+const FLOAT_MAX: f32 = 3.0e38;
+const INACTIVE_POINT: u32 = 0xffffffffu;
+
+struct Partial {
+    sumPosition: vec4f,      // xyz: sum of positions, w: point count
+    minPosition: vec4f,
+    maxPosition: vec4f,
+    sumVelocity: vec4f,      // xyz: sum of velocities, w: sum of squared speeds
+    sumVelocitySq: vec4f,    // Per-axis sum of squared velocities
+    angularMomentum: vec4f,  // Sum of position x velocity about the origin
+    histogram: array<u32, 32>,  // Points per radial shell; the last bin also counts everything beyond
+}
+
+struct Params {
+    histogramRadius: f32,
+    timeStep: f32,
+    pointCount: u32,
+    partialCount: u32,
+}
+
+// Two consecutive simulation steps, so velocities are their difference over the step
+@group(0) @binding(0) var<storage, read> previous: array<Point>;
+@group(0) @binding(1) var<storage, read> current: array<Point>;
+@group(0) @binding(2) var<storage, read_write> partials: array<Partial>;
+@group(0) @binding(3) var<storage, read_write> result: Partial;
+@group(0) @binding(4) var<uniform> params: Params;
+
+struct Accumulator {
+    sumPosition: vec4f,
+    minPosition: vec4f,
+    maxPosition: vec4f,
+    sumVelocity: vec4f,
+    sumVelocitySq: vec4f,
+    angularMomentum: vec4f,
+}
+
+var<workgroup> sharedSumPosition: array<vec4f, WORKGROUP_SIZE>;
+var<workgroup> sharedMinPosition: array<vec4f, WORKGROUP_SIZE>;
+var<workgroup> sharedMaxPosition: array<vec4f, WORKGROUP_SIZE>;
+var<workgroup> sharedSumVelocity: array<vec4f, WORKGROUP_SIZE>;
+var<workgroup> sharedSumVelocitySq: array<vec4f, WORKGROUP_SIZE>;
+var<workgroup> sharedAngularMomentum: array<vec4f, WORKGROUP_SIZE>;
+var<workgroup> sharedHistogram: array<atomic<u32>, HISTOGRAM_BINS>;
+
+fn emptyAccumulator() -> Accumulator {
+    return Accumulator(vec4f(0.0), vec4f(FLOAT_MAX), vec4f(-FLOAT_MAX), vec4f(0.0), vec4f(0.0), vec4f(0.0));
+}
+
+fn combine(a: Accumulator, b: Accumulator) -> Accumulator {
+    return Accumulator(
+        a.sumPosition + b.sumPosition,
+        min(a.minPosition, b.minPosition),
+        max(a.maxPosition, b.maxPosition),
+        a.sumVelocity + b.sumVelocity,
+        a.sumVelocitySq + b.sumVelocitySq,
+        a.angularMomentum + b.angularMomentum
+    );
+}
+
+fn storeShared(index: u32, value: Accumulator) {
+    sharedSumPosition[index] = value.sumPosition;
+    sharedMinPosition[index] = value.minPosition;
+    sharedMaxPosition[index] = value.maxPosition;
+    sharedSumVelocity[index] = value.sumVelocity;
+    sharedSumVelocitySq[index] = value.sumVelocitySq;
+    sharedAngularMomentum[index] = value.angularMomentum;
+}
+
+fn loadShared(index: u32) -> Accumulator {
+    return Accumulator(
+        sharedSumPosition[index],
+        sharedMinPosition[index],
+        sharedMaxPosition[index],
+        sharedSumVelocity[index],
+        sharedSumVelocitySq[index],
+        sharedAngularMomentum[index]
+    );
+}
+
+// Halves the active threads each step until slot 0 holds the whole workgroup's value
+fn treeReduce(local: u32) {
+    for (var stride = WORKGROUP_SIZE / 2u; stride > 0u; stride = stride / 2u) {
+        if (local < stride) {
+            storeShared(local, combine(loadShared(local), loadShared(local + stride)));
+        }
+        workgroupBarrier();
+    }
+}
+
+fn writeAccumulator(index: u32, value: Accumulator) {
+    partials[index].sumPosition = value.sumPosition;
+    partials[index].minPosition = value.minPosition;
+    partials[index].maxPosition = value.maxPosition;
+    partials[index].sumVelocity = value.sumVelocity;
+    partials[index].sumVelocitySq = value.sumVelocitySq;
+    partials[index].angularMomentum = value.angularMomentum;
+}
+
+fn readAccumulator(index: u32) -> Accumulator {
+    return Accumulator(
+        partials[index].sumPosition,
+        partials[index].minPosition,
+        partials[index].maxPosition,
+        partials[index].sumVelocity,
+        partials[index].sumVelocitySq,
+        partials[index].angularMomentum
+    );
+}
+
+@compute @workgroup_size(128)
+fn reduce_partials(@builtin(local_invocation_index) local: u32,
+                   @builtin(workgroup_id) group: vec3u,
+                   @builtin(num_workgroups) groupCount: vec3u) {
+    if (local < HISTOGRAM_BINS) {
+        atomicStore(&sharedHistogram[local], 0u);
+    }
+    workgroupBarrier();
+
+    var value = emptyAccumulator();
+    let stride = groupCount.x * WORKGROUP_SIZE;
+    for (var i = group.x * WORKGROUP_SIZE + local; i < params.pointCount; i = i + stride) {
+        if (current[i].ellipse == INACTIVE_POINT) {
+            continue;
+        }
+        let position = current[i].position;
+        let velocity = (position - previous[i].position) / params.timeStep;
+
+        value.sumPosition += vec4f(position, 1.0);
+        value.minPosition = min(value.minPosition, vec4f(position, 0.0));
+        value.maxPosition = max(value.maxPosition, vec4f(position, 0.0));
+        value.sumVelocity += vec4f(velocity, dot(velocity, velocity));
+        value.sumVelocitySq += vec4f(velocity * velocity, 0.0);
+        value.angularMomentum += vec4f(cross(position, velocity), 0.0);
+
+        let bin = u32(length(position) / params.histogramRadius * f32(HISTOGRAM_BINS));
+        atomicAdd(&sharedHistogram[min(bin, HISTOGRAM_BINS - 1u)], 1u);
+    }
+
+    storeShared(local, value);
+    workgroupBarrier();
+    treeReduce(local);
+
+    if (local == 0u) {
+        writeAccumulator(group.x, loadShared(0u));
+    }
+    if (local < HISTOGRAM_BINS) {
+        partials[group.x].histogram[local] = atomicLoad(&sharedHistogram[local]);
+    }
+}
+
+@compute @workgroup_size(128)
+fn reduce_final(@builtin(local_invocation_index) local: u32) {
+    var value = emptyAccumulator();
+    for (var i = local; i < params.partialCount; i = i + WORKGROUP_SIZE) {
+        value = combine(value, readAccumulator(i));
+    }
+
+    storeShared(local, value);
+    workgroupBarrier();
+    treeReduce(local);
+
+    if (local == 0u) {
+        let total = loadShared(0u);
+        result.sumPosition = total.sumPosition;
+        result.minPosition = total.minPosition;
+        result.maxPosition = total.maxPosition;
+        result.sumVelocity = total.sumVelocity;
+        result.sumVelocitySq = total.sumVelocitySq;
+        result.angularMomentum = total.angularMomentum;
+    }
+    if (local < HISTOGRAM_BINS) {
+        var count = 0u;
+        for (var i = 0u; i < params.partialCount; i = i + 1u) {
+            count += partials[i].histogram[local];
+        }
+        result.histogram[local] = count;
+    }
+}
@@ -0,0 +1,81 @@
+struct Point {
+    @align(16) position: vec3f,
+    ellipse: u32,  // Owning ellipse, or INACTIVE_POINT for an unused slot
+    @align(16) velocity: vec3f,
+}
+
+struct EllipseParams {
+    majorAxis: f32,
+    minorAxis: f32,
+    tiltAngle: f32,
+    speed: f32,
+}
+
+const INACTIVE_POINT: u32 = 0xffffffffu;
+
+@group(0) @binding(0) var<storage, read> input: array<Point>;
+@group(0) @binding(1) var<storage, read_write> output: array<Point>;
+@group(0) @binding(2) var<storage, read> ellipses: array<EllipseParams>;
+
+const BASE_ROTATION_SPEED: f32 = -0.01;
+const SPEED_MULTIPLIER: f32 = 20.0;
+
+fn hash(n: u32) -> f32 {
+    var nn = n;
+    nn = (nn << 13u) ^ nn;
+    nn = nn * (nn * nn * 15731u + 0x789221u) + 0x137631u;
+    return f32(nn & 0x7fffffffu) / f32(0x7fffffff);
+}
+
+@compute @workgroup_size(256)
+fn main(@builtin(global_invocation_id) global_id : vec3u) {
+    let index = global_id.x;
+    if (index >= arrayLength(&input)) {
+        return;
+    }
+
+    // Unused slots are carried over so both buffers agree
+    let ellipseIndex = input[index].ellipse;
+    if (ellipseIndex == INACTIVE_POINT) {
+        output[index] = input[index];
+        return;
+    }
+    let params = ellipses[min(ellipseIndex, arrayLength(&ellipses) - 1u)];
+
+    // Get stored parameters
+    let currentAngle = input[index].velocity.x;
+    let storedHeight = input[index].velocity.y;
+    let radialOffset = input[index].velocity.z;
+
+    // Calculate rotation speed based on ellipse size
+    let speedFactor = SPEED_MULTIPLIER / max(params.majorAxis, 0.1);
+    let rotationSpeed = BASE_ROTATION_SPEED * speedFactor * params.speed;
+
+    // Update angle
+    var newAngle = currentAngle + rotationSpeed * 0.016;
+    if (newAngle > 6.28318) {
+        newAngle = newAngle - 6.28318;
+    }
+
+    // Calculate base ellipse position
+    let x = params.majorAxis * cos(newAngle) * cos(params.tiltAngle) -
+            params.minorAxis * sin(newAngle) * sin(params.tiltAngle);
+    let z = params.majorAxis * cos(newAngle) * sin(params.tiltAngle) +
+            params.minorAxis * sin(newAngle) * cos(params.tiltAngle);
+
+    // Apply stored radial offset in orbital plane
+    let offsetAngle = newAngle + radialOffset;
+    let offset = vec3f(
+        cos(offsetAngle) * radialOffset,
+        0.0,
+        sin(offsetAngle) * radialOffset
+    );
+
+    // Combine position with stored height
+    let newPosition = vec3f(x, storedHeight, z) + offset;
+
+    // Update the point
+    output[index].position = newPosition;
+    output[index].ellipse = ellipseIndex;
+    output[index].velocity = vec3f(newAngle, storedHeight, radialOffset);
+}
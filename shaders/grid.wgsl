@@ -0,0 +1,73 @@
+struct Uniforms {
+    inverseViewProj: mat4x4<f32>,
+    cameraPosition: vec4f,
+}
+@binding(0) @group(0) var<uniform> uniforms: Uniforms;
+
+struct VertexOutput {
+    @builtin(position) position: vec4f,
+    @location(0) ndc: vec2f,
+};
+
+// Fullscreen triangle; the ground plane is found per pixel by casting a ray through it
+@vertex
+fn vs_main(@builtin(vertex_index) vertexIndex: u32) -> VertexOutput {
+    let pos = vec2f(f32((vertexIndex << 1u) & 2u), f32(vertexIndex & 2u)) * 2.0 - 1.0;
+    var out: VertexOutput;
+    out.position = vec4f(pos, 0.0, 1.0);
+    out.ndc = pos;
+    return out;
+}
+
+fn unproject(ndc: vec2f, depth: f32) -> vec3f {
+    let world = uniforms.inverseViewProj * vec4f(ndc, depth, 1.0);
+    return world.xyz / world.w;
+}
+
+// Coverage of lines every `spacing` units, anti-aliased to about one pixel with screen derivatives
+fn gridLines(coord: vec2f, spacing: f32) -> f32 {
+    let cell = coord / spacing;
+    let width = fwidth(cell);
+    let distToLine = abs(fract(cell - 0.5) - 0.5) / width;
+    let line = 1.0 - min(min(distToLine.x, distToLine.y), 1.0);
+    // Lines closer together than a pixel would only alias, so fade them out
+    return line * (1.0 - smoothstep(0.3, 1.0, max(width.x, width.y)));
+}
+
+@fragment
+fn fs_main(in: VertexOutput) -> @location(0) vec4f {
+    let nearPoint = unproject(in.ndc, 0.0);
+    let farPoint = unproject(in.ndc, 1.0);
+    let dir = farPoint - nearPoint;
+
+    // Intersect the view ray with y = 0, keeping the derivatives valid before discarding
+    let t = -nearPoint.y / dir.y;
+    let hit = nearPoint + dir * t;
+    let coord = hit.xz;
+
+    // Spacing steps by powers of ten with camera height; the finer level fades out as we rise
+    let height = max(abs(uniforms.cameraPosition.y), 1.0);
+    let lod = log10(height);
+    let spacing = pow(10.0, floor(lod));
+    let lodFade = fract(lod);
+
+    let minor = gridLines(coord, spacing) * 0.25 * (1.0 - lodFade);
+    let major = gridLines(coord, spacing * 10.0) * mix(0.5, 0.25, lodFade);
+    let coarse = gridLines(coord, spacing * 100.0) * 0.5 * lodFade;
+
+    // X and Z axes
+    let axisWidth = fwidth(coord);
+    let axisDist = abs(coord) / axisWidth;
+    let axis = 1.0 - min(min(axisDist.x, axisDist.y), 1.0);
+
+    var alpha = max(max(minor, major), max(coarse, axis));
+
+    // Fade with distance so the horizon doesn't turn into noise
+    let viewDistance = length(hit - uniforms.cameraPosition.xyz);
+    alpha *= 1.0 - smoothstep(height * 20.0, height * 60.0, viewDistance);
+
+    if (t <= 0.0 || alpha <= 0.001) {
+        discard;
+    }
+    return vec4f(1.0, 1.0, 1.0, alpha);
+}
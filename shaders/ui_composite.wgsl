@@ -0,0 +1,14 @@
+// Composites the cached UI layer (premultiplied alpha, same size as the output) over the frame
+@binding(0) @group(0) var uiTexture: texture_2d<f32>;
+
+// Fullscreen triangle, no vertex buffer
+@vertex
+fn vs_main(@builtin(vertex_index) vertexIndex: u32) -> @builtin(position) vec4f {
+    let pos = vec2f(f32((vertexIndex << 1u) & 2u), f32(vertexIndex & 2u));
+    return vec4f(pos * 2.0 - 1.0, 0.0, 1.0);
+}
+
+@fragment
+fn fs_main(@builtin(position) position: vec4f) -> @location(0) vec4f {
+    return textureLoad(uiTexture, vec2i(position.xy), 0);
+}
@@ -0,0 +1,28 @@
+struct Params {
+    uvScale: vec2f,  // Fraction of the scene texture that was rendered to
+    uvMax: vec2f,    // Clamp so linear filtering never reads past the rendered region
+}
+@binding(0) @group(0) var sceneTexture: texture_2d<f32>;
+@binding(1) @group(0) var sceneSampler: sampler;
+@binding(2) @group(0) var<uniform> params: Params;
+
+struct VertexOutput {
+    @builtin(position) position: vec4f,
+    @location(0) uv: vec2f,
+};
+
+// Fullscreen triangle, no vertex buffer
+@vertex
+fn vs_main(@builtin(vertex_index) vertexIndex: u32) -> VertexOutput {
+    let pos = vec2f(f32((vertexIndex << 1u) & 2u), f32(vertexIndex & 2u));
+    var out: VertexOutput;
+    out.position = vec4f(pos * 2.0 - 1.0, 0.0, 1.0);
+    out.uv = vec2f(pos.x, 1.0 - pos.y);
+    return out;
+}
+
+@fragment
+fn fs_main(in: VertexOutput) -> @location(0) vec4f {
+    let uv = min(in.uv * params.uvScale, params.uvMax);
+    return textureSample(sceneTexture, sceneSampler, uv);
+}
@@ -0,0 +1,26 @@
+#include "AsyncPump.h"
+
+void AsyncPump::schedule(std::coroutine_handle<> handle) {
+    std::lock_guard<std::mutex> lock(mutex);
+    ready.push_back(handle);
+}
+
+void AsyncPump::run() {
+    // Coroutines awaiting nextFrame() during this run wait for the next one
+    std::vector<std::coroutine_handle<>> resumable;
+    resumable.swap(nextFrameQueue);
+
+    while (true) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            resumable.insert(resumable.end(), ready.begin(), ready.end());
+            ready.clear();
+        }
+        if (resumable.empty()) break;
+
+        for (std::coroutine_handle<> handle : resumable) {
+            handle.resume();
+        }
+        resumable.clear();
+    }
+}
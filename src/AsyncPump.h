@@ -0,0 +1,168 @@
+#pragma once
+
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Coroutine that produces a T. Tasks start suspended and run when awaited, or when handed to
+// AsyncPump::spawn(); when one finishes it resumes whoever awaited it.
+template <typename T = void>
+class Task;
+
+namespace detail {
+
+struct TaskPromiseBase {
+    std::coroutine_handle<> continuation = std::noop_coroutine();
+
+    std::suspend_always initial_suspend() noexcept { return {}; }
+
+    struct FinalAwaiter {
+        bool await_ready() noexcept { return false; }
+        template <typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+            return handle.promise().continuation;
+        }
+        void await_resume() noexcept {}
+    };
+    FinalAwaiter final_suspend() noexcept { return {}; }
+
+    // Exceptions are disabled in web builds
+    void unhandled_exception() { std::terminate(); }
+};
+
+template <typename T>
+struct TaskPromise : TaskPromiseBase {
+    std::optional<T> value;
+
+    Task<T> get_return_object();
+    void return_value(T result) { value = std::move(result); }
+};
+
+template <>
+struct TaskPromise<void> : TaskPromiseBase {
+    Task<void> get_return_object();
+    void return_void() {}
+};
+
+}  // namespace detail
+
+template <typename T>
+class Task {
+public:
+    using promise_type = detail::TaskPromise<T>;
+
+    Task() = default;
+    explicit Task(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+    Task(Task&& other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            if (handle) handle.destroy();
+            handle = std::exchange(other.handle, nullptr);
+        }
+        return *this;
+    }
+    ~Task() {
+        if (handle) handle.destroy();
+    }
+
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    bool await_ready() const noexcept { return !handle || handle.done(); }
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+        handle.promise().continuation = awaiting;
+        return handle;
+    }
+    T await_resume() {
+        if constexpr (!std::is_void_v<T>) return std::move(*handle.promise().value);
+    }
+
+private:
+    std::coroutine_handle<promise_type> handle;
+};
+
+namespace detail {
+
+template <typename T>
+Task<T> TaskPromise<T>::get_return_object() {
+    return Task<T>(std::coroutine_handle<TaskPromise<T>>::from_promise(*this));
+}
+
+inline Task<void> TaskPromise<void>::get_return_object() {
+    return Task<void>(std::coroutine_handle<TaskPromise<void>>::from_promise(*this));
+}
+
+}  // namespace detail
+
+// Resumes coroutines whose WebGPU callbacks have fired, once per frame on the thread that
+// renders (the render thread while it runs, otherwise the main thread), since that side owns
+// the engine objects coroutines work with.
+//
+// Callbacks only queue the waiting coroutine, whichever thread delivers them, so coroutine
+// code never runs re-entrantly inside WebGPU or concurrently with the frame. Suspended tasks
+// must not outlive the pump.
+class AsyncPump {
+public:
+    AsyncPump() = default;
+    AsyncPump(const AsyncPump&) = delete;
+    AsyncPump& operator=(const AsyncPump&) = delete;
+
+    // Starts task right away; the pump keeps it alive until it finishes
+    template <typename T>
+    void spawn(Task<T> task) {
+        runDetached(std::move(task), *this);
+    }
+
+    // Queues a suspended coroutine for the next run(); safe from any thread
+    void schedule(std::coroutine_handle<> handle);
+
+    // Resumes everything that became ready, including coroutines that become ready meanwhile
+    void run();
+
+    // Awaitable that resumes at the next run()
+    auto nextFrame() {
+        struct Awaiter {
+            AsyncPump& pump;
+            bool await_ready() const noexcept { return false; }
+            void await_suspend(std::coroutine_handle<> handle) { pump.scheduleNextFrame(handle); }
+            void await_resume() const noexcept {}
+        };
+        return Awaiter{*this};
+    }
+
+    size_t getSpawnedCount() const { return spawnedCount; }
+    size_t getRunningCount() const { return runningCount; }
+
+private:
+    // Self-destroying coroutine that owns a spawned task
+    struct Detached {
+        struct promise_type {
+            Detached get_return_object() { return {}; }
+            std::suspend_never initial_suspend() noexcept { return {}; }
+            std::suspend_never final_suspend() noexcept { return {}; }
+            void return_void() {}
+            void unhandled_exception() { std::terminate(); }
+        };
+    };
+
+    template <typename T>
+    static Detached runDetached(Task<T> task, AsyncPump& pump) {
+        pump.spawnedCount++;
+        pump.runningCount++;
+        co_await task;
+        pump.runningCount--;
+    }
+
+    void scheduleNextFrame(std::coroutine_handle<> handle) { nextFrameQueue.push_back(handle); }
+
+    std::mutex mutex;
+    std::vector<std::coroutine_handle<>> ready;           // Guarded by mutex
+    std::vector<std::coroutine_handle<>> nextFrameQueue;  // Thread calling run() only
+    size_t spawnedCount = 0;
+    size_t runningCount = 0;
+};
@@ -0,0 +1,76 @@
+#include "BakedFontAtlas.h"
+#include "imgui.h"
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+struct BakedGlyph {
+    unsigned int codepoint;
+    float advanceX;
+    float x0, y0, x1, y1;
+    float u0, v0, u1, v1;
+};
+
+#if __has_include("font_atlas.inc")
+#define HAS_BAKED_FONT_ATLAS 1
+#include "font_atlas.inc"
+#endif
+
+} // namespace
+
+bool BakedFontAtlas::load(ImFontAtlas* atlas) {
+#ifdef HAS_BAKED_FONT_ATLAS
+    if (BAKED_IMGUI_VERSION != IMGUI_VERSION_NUM) {
+        printf("Baked font atlas is for ImGui %d, building the atlas at runtime\n", BAKED_IMGUI_VERSION);
+        return false;
+    }
+    if (atlas->Fonts.Size > 0 || atlas->ConfigData.Size > 0 || atlas->Flags != BAKED_ATLAS_FLAGS) return false;
+
+    atlas->TexWidth = BAKED_ATLAS_WIDTH;
+    atlas->TexHeight = BAKED_ATLAS_HEIGHT;
+    atlas->TexUvScale = ImVec2(1.0f / BAKED_ATLAS_WIDTH, 1.0f / BAKED_ATLAS_HEIGHT);
+    atlas->TexUvWhitePixel = ImVec2(BAKED_WHITE_PIXEL[0], BAKED_WHITE_PIXEL[1]);
+    for (int i = 0; i <= IM_DRAWLIST_TEX_LINES_WIDTH_MAX; i++) {
+        atlas->TexUvLines[i] = ImVec4(BAKED_UV_LINES[i][0], BAKED_UV_LINES[i][1], BAKED_UV_LINES[i][2], BAKED_UV_LINES[i][3]);
+    }
+
+    // Pixels are stored as (count, value) runs
+    unsigned char* pixels = (unsigned char*)IM_ALLOC((size_t)BAKED_ATLAS_WIDTH * BAKED_ATLAS_HEIGHT);
+    unsigned char* dst = pixels;
+    for (size_t i = 0; i < sizeof(BAKED_PIXELS_RLE); i += 2) {
+        memset(dst, BAKED_PIXELS_RLE[i + 1], BAKED_PIXELS_RLE[i]);
+        dst += BAKED_PIXELS_RLE[i];
+    }
+    IM_ASSERT(dst == pixels + BAKED_ATLAS_WIDTH * BAKED_ATLAS_HEIGHT);
+    atlas->TexPixelsAlpha8 = pixels;
+
+    // Software mouse cursors are read from this region (io.MouseDrawCursor)
+    ImFontAtlasCustomRect cursors;
+    cursors.X = BAKED_CURSOR_RECT[0];
+    cursors.Y = BAKED_CURSOR_RECT[1];
+    cursors.Width = BAKED_CURSOR_RECT[2];
+    cursors.Height = BAKED_CURSOR_RECT[3];
+    atlas->CustomRects.push_back(cursors);
+    atlas->PackIdMouseCursors = atlas->CustomRects.Size - 1;
+
+    ImFont* font = IM_NEW(ImFont);
+    font->ContainerAtlas = atlas;
+    font->FontSize = BAKED_FONT_METRICS[0];
+    font->Ascent = BAKED_FONT_METRICS[1];
+    font->Descent = BAKED_FONT_METRICS[2];
+    for (const BakedGlyph& glyph : BAKED_GLYPHS) {
+        font->AddGlyph(nullptr, (ImWchar)glyph.codepoint, glyph.x0, glyph.y0, glyph.x1, glyph.y1,
+                       glyph.u0, glyph.v0, glyph.u1, glyph.v1, glyph.advanceX);
+    }
+    font->BuildLookupTable();
+    atlas->Fonts.push_back(font);
+
+    // With pixels present and TexReady set, GetTexDataAs*() never calls Build()
+    atlas->TexReady = true;
+    return true;
+#else
+    (void)atlas;
+    return false;
+#endif
+}
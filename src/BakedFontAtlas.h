@@ -0,0 +1,12 @@
+#pragma once
+
+struct ImFontAtlas;
+
+// Fills an ImFontAtlas from the atlas baked at build time by tools/bake_font_atlas.cpp, so startup
+// skips decompressing and rasterizing the default font. The atlas is left untouched (and ImGui
+// builds it as usual) when the baked data is missing, was made by another ImGui version, or the
+// atlas was already given fonts or non-default flags.
+class BakedFontAtlas {
+public:
+    static bool load(ImFontAtlas* atlas);
+};
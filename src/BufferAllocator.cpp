@@ -0,0 +1,217 @@
+#include "BufferAllocator.h"
+#include <cstdio>
+#include <algorithm>
+#include <cstring>
+
+BufferAllocator::BufferAllocator(WGPUDevice device) : device(device) {
+    WGPUBufferDescriptor transientDesc = {};
+    transientDesc.label = "Transient arena";
+    transientDesc.size = TRANSIENT_CAPACITY;
+    transientDesc.usage = USAGE;
+    transientBuffer = wgpuDeviceCreateBuffer(device, &transientDesc);
+    transientStaging.resize(TRANSIENT_CAPACITY);
+}
+
+BufferAllocator::~BufferAllocator() {
+    for (Block& block : blocks) {
+        if (block.buffer) wgpuBufferRelease(block.buffer);
+    }
+    if (transientBuffer) wgpuBufferRelease(transientBuffer);
+}
+
+uint64_t BufferAllocator::alignmentFor(BufferUsageKind usage) {
+    // WebGPU's default minUniformBufferOffsetAlignment / minStorageBufferOffsetAlignment
+    switch (usage) {
+        case BufferUsageKind::Uniform: return 256;
+        case BufferUsageKind::Storage: return 256;
+        case BufferUsageKind::Vertex: return 4;
+    }
+    return 256;
+}
+
+uint32_t BufferAllocator::orderFor(uint64_t size) {
+    uint32_t order = MIN_ORDER;
+    while ((uint64_t(1) << order) < size) order++;
+    return order;
+}
+
+// MARK: Static allocations
+
+uint32_t BufferAllocator::createBlock() {
+    WGPUBufferDescriptor blockDesc = {};
+    blockDesc.label = "Buffer allocator block";
+    blockDesc.size = uint64_t(1) << BLOCK_ORDER;
+    blockDesc.usage = USAGE;
+
+    // Reuse the slot of a block released by defragment()
+    uint32_t index = 0;
+    while (index < blocks.size() && blocks[index].buffer) index++;
+    if (index == blocks.size()) blocks.emplace_back();
+
+    Block& block = blocks[index];
+    block.buffer = wgpuDeviceCreateBuffer(device, &blockDesc);
+    block.freeLists[BLOCK_ORDER - MIN_ORDER].insert(0);
+    return index;
+}
+
+bool BufferAllocator::allocateFromBlock(Block& block, uint32_t order, uint64_t& offset) {
+    // Find the smallest free range that fits, then split it down to the requested order
+    uint32_t found = order;
+    while (found <= BLOCK_ORDER && block.freeLists[found - MIN_ORDER].empty()) found++;
+    if (found > BLOCK_ORDER) return false;
+
+    std::set<uint64_t>& freeList = block.freeLists[found - MIN_ORDER];
+    offset = *freeList.begin();
+    freeList.erase(freeList.begin());
+
+    while (found > order) {
+        found--;
+        block.freeLists[found - MIN_ORDER].insert(offset + (uint64_t(1) << found));
+    }
+
+    block.allocatedOrders[offset] = order;
+    block.usedBytes += uint64_t(1) << order;
+    return true;
+}
+
+BufferAllocation BufferAllocator::allocate(uint64_t size) {
+    BufferAllocation allocation;
+    allocation.size = size;
+    if (size == 0) return allocation;
+
+    // Too big to share a block
+    if (size > (uint64_t(1) << BLOCK_ORDER)) {
+        WGPUBufferDescriptor bufferDesc = {};
+        bufferDesc.size = (size + 3) & ~uint64_t(3);
+        bufferDesc.usage = USAGE;
+        allocation.buffer = wgpuDeviceCreateBuffer(device, &bufferDesc);
+        dedicatedCount++;
+        dedicatedBytes += bufferDesc.size;
+        return allocation;
+    }
+
+    uint32_t order = orderFor(size);
+    for (uint32_t i = 0; i < blocks.size(); i++) {
+        if (blocks[i].buffer && allocateFromBlock(blocks[i], order, allocation.offset)) {
+            allocation.buffer = blocks[i].buffer;
+            allocation.block = i;
+            return allocation;
+        }
+    }
+
+    uint32_t index = createBlock();
+    allocateFromBlock(blocks[index], order, allocation.offset);
+    allocation.buffer = blocks[index].buffer;
+    allocation.block = index;
+    return allocation;
+}
+
+void BufferAllocator::free(BufferAllocation& allocation) {
+    if (!allocation) return;
+
+    if (allocation.block == UINT32_MAX) {
+        wgpuBufferRelease(allocation.buffer);
+        dedicatedCount--;
+        dedicatedBytes -= (allocation.size + 3) & ~uint64_t(3);
+        allocation = {};
+        return;
+    }
+
+    Block& block = blocks[allocation.block];
+    auto it = block.allocatedOrders.find(allocation.offset);
+    if (it == block.allocatedOrders.end()) {
+        printf("BufferAllocator: double free at offset %llu\n", (unsigned long long)allocation.offset);
+        return;
+    }
+    uint32_t order = it->second;
+    block.allocatedOrders.erase(it);
+    block.usedBytes -= uint64_t(1) << order;
+
+    // Merge with the buddy for as long as it is free too
+    uint64_t offset = allocation.offset;
+    while (order < BLOCK_ORDER) {
+        uint64_t buddy = offset ^ (uint64_t(1) << order);
+        std::set<uint64_t>& freeList = block.freeLists[order - MIN_ORDER];
+        auto buddyIt = freeList.find(buddy);
+        if (buddyIt == freeList.end()) break;
+        freeList.erase(buddyIt);
+        offset = std::min(offset, buddy);
+        order++;
+    }
+    block.freeLists[order - MIN_ORDER].insert(offset);
+
+    allocation = {};
+}
+
+void BufferAllocator::write(const BufferAllocation& allocation, const void* data, uint64_t size) {
+    if (!allocation) return;
+    wgpuQueueWriteBuffer(wgpuDeviceGetQueue(device), allocation.buffer, allocation.offset, data, size);
+}
+
+size_t BufferAllocator::defragment() {
+    // Keep one empty block around so the next allocation doesn't hit the driver
+    size_t released = 0;
+    bool keptEmpty = false;
+    for (Block& block : blocks) {
+        if (!block.buffer || block.usedBytes > 0) continue;
+        if (!keptEmpty) {
+            keptEmpty = true;
+            continue;
+        }
+        wgpuBufferRelease(block.buffer);
+        block = Block{};
+        released++;
+    }
+    return released;
+}
+
+// MARK: Transient arena
+
+BufferAllocation BufferAllocator::allocateTransient(const void* data, uint64_t size, BufferUsageKind usage) {
+    uint64_t alignment = alignmentFor(usage);
+    uint64_t offset = (transientUsed + alignment - 1) & ~(alignment - 1);
+    if (offset + size > TRANSIENT_CAPACITY) {
+        if (!reportedTransientOverflow) {
+            printf("BufferAllocator: transient arena full (%llu bytes)\n", (unsigned long long)TRANSIENT_CAPACITY);
+            reportedTransientOverflow = true;
+        }
+        return {};
+    }
+
+    memcpy(transientStaging.data() + offset, data, size);
+    transientUsed = offset + size;
+
+    BufferAllocation allocation;
+    allocation.buffer = transientBuffer;
+    allocation.offset = offset;
+    allocation.size = size;
+    return allocation;
+}
+
+void BufferAllocator::flushTransient(WGPUQueue queue) {
+    if (transientUsed > 0) {
+        // Writes must be a multiple of 4 bytes
+        uint64_t writeSize = (transientUsed + 3) & ~uint64_t(3);
+        wgpuQueueWriteBuffer(queue, transientBuffer, 0, transientStaging.data(), writeSize);
+    }
+    lastTransientBytes = transientUsed;
+    transientUsed = 0;
+}
+
+BufferAllocator::Stats BufferAllocator::getStats() const {
+    Stats stats;
+    for (const Block& block : blocks) {
+        if (!block.buffer) continue;
+        stats.blockCount++;
+        stats.allocationCount += block.allocatedOrders.size();
+        stats.reservedBytes += uint64_t(1) << BLOCK_ORDER;
+        stats.usedBytes += block.usedBytes;
+    }
+    stats.dedicatedCount = dedicatedCount;
+    stats.allocationCount += dedicatedCount;
+    stats.reservedBytes += dedicatedBytes;
+    stats.usedBytes += dedicatedBytes;
+    stats.transientBytes = lastTransientBytes;
+    stats.transientCapacity = TRANSIENT_CAPACITY;
+    return stats;
+}
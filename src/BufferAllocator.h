@@ -0,0 +1,104 @@
+#pragma once
+
+#include <webgpu/webgpu.h>
+#include <cstdint>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+// What a suballocation will be bound as; decides its offset alignment
+enum class BufferUsageKind {
+    Uniform,
+    Storage,
+    Vertex,
+};
+
+struct BufferAllocation {
+    WGPUBuffer buffer = nullptr;
+    uint64_t offset = 0;
+    uint64_t size = 0;
+
+    explicit operator bool() const { return buffer != nullptr; }
+
+private:
+    friend class BufferAllocator;
+    uint32_t block = UINT32_MAX;  // Owning block, or UINT32_MAX for transient/dedicated
+};
+
+// Hands out ranges of a few large device buffers instead of one buffer per resource.
+//
+// Long-lived data comes from buddy-allocated blocks; every range is aligned to its own
+// power-of-two size (at least 256 bytes), which satisfies uniform, storage and vertex
+// offset rules. Requests larger than a block get a dedicated buffer.
+//
+// Per-frame data comes from a linear arena that is reset every frame. Its contents are
+// staged on the CPU and written with a single wgpuQueueWriteBuffer in flushTransient(),
+// which must happen before the frame is submitted. Because queue writes are ordered with
+// submits, one arena region is enough; earlier frames still see the data they were given.
+class BufferAllocator {
+public:
+    explicit BufferAllocator(WGPUDevice device);
+    ~BufferAllocator();
+
+    BufferAllocator(const BufferAllocator&) = delete;
+    BufferAllocator& operator=(const BufferAllocator&) = delete;
+
+    BufferAllocation allocate(uint64_t size);
+    void free(BufferAllocation& allocation);
+    void write(const BufferAllocation& allocation, const void* data, uint64_t size);
+
+    // Copies data into this frame's arena; the allocation is only valid for this frame
+    BufferAllocation allocateTransient(const void* data, uint64_t size, BufferUsageKind usage);
+    void flushTransient(WGPUQueue queue);
+
+    // The arena buffer, for bind groups that use dynamic offsets into it
+    WGPUBuffer getTransientBuffer() const { return transientBuffer; }
+
+    // Defragmentation hook. Live allocations are never moved (owners hold raw offsets in
+    // their bind groups), so this only returns fully empty blocks to the driver.
+    size_t defragment();
+
+    struct Stats {
+        size_t blockCount = 0;
+        size_t dedicatedCount = 0;
+        size_t allocationCount = 0;
+        uint64_t reservedBytes = 0;
+        uint64_t usedBytes = 0;
+        uint64_t transientBytes = 0;      // Used by the last flushed frame
+        uint64_t transientCapacity = 0;
+    };
+    Stats getStats() const;
+
+    // Alignment required for an offset bound as the given usage
+    static uint64_t alignmentFor(BufferUsageKind usage);
+
+    static constexpr WGPUBufferUsageFlags USAGE =
+        WGPUBufferUsage_Uniform | WGPUBufferUsage_Storage | WGPUBufferUsage_Vertex | WGPUBufferUsage_CopyDst;
+
+private:
+    static constexpr uint32_t MIN_ORDER = 8;    // 256 bytes
+    static constexpr uint32_t BLOCK_ORDER = 20; // 1 MB
+    static constexpr uint64_t TRANSIENT_CAPACITY = 256 * 1024;
+
+    struct Block {
+        WGPUBuffer buffer = nullptr;
+        std::set<uint64_t> freeLists[BLOCK_ORDER - MIN_ORDER + 1];  // Free offsets per order
+        std::unordered_map<uint64_t, uint32_t> allocatedOrders;     // Offset -> order
+        uint64_t usedBytes = 0;
+    };
+
+    static uint32_t orderFor(uint64_t size);
+    bool allocateFromBlock(Block& block, uint32_t order, uint64_t& offset);
+    uint32_t createBlock();
+
+    WGPUDevice device;
+    std::vector<Block> blocks;  // Released blocks keep their slot with a null buffer
+    size_t dedicatedCount = 0;
+    uint64_t dedicatedBytes = 0;
+
+    WGPUBuffer transientBuffer = nullptr;
+    std::vector<uint8_t> transientStaging;
+    uint64_t transientUsed = 0;
+    uint64_t lastTransientBytes = 0;
+    bool reportedTransientOverflow = false;
+};
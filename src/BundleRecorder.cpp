@@ -0,0 +1,26 @@
+#include "BundleRecorder.h"
+
+void BundleRecorder::add(RenderBundleCache& cache, uint64_t key, const char* label, Commands commands) {
+    recordings.push_back({&cache, key, label, std::move(commands)});
+}
+
+void BundleRecorder::record(WGPUDevice device, WGPUTextureFormat colorFormat) {
+    auto recordRange = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            Recording& recording = recordings[i];
+            WGPURenderBundleEncoder encoder = recording.cache->begin(device, colorFormat, recording.label);
+            recording.commands(encoder);
+            recording.cache->finish(encoder, recording.key);
+        }
+    };
+
+    // Bundles are rarely stale, so the job system is only involved when there is work to split
+    if (parallel && recordings.size() > 1) {
+        jobs.parallelFor(0, recordings.size(), 1, recordRange);
+    } else {
+        recordRange(0, recordings.size());
+    }
+
+    lastRecordCount = recordings.size();
+    recordings.clear();
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <webgpu/webgpu.h>
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "RenderBundleCache.h"
+#include "JobSystem.h"
+
+// Gathers the render bundles that went stale this frame and records them all in one go.
+//
+// Renderers update their uniforms and queue their commands serially, then record() encodes
+// every queued bundle, one job per bundle on the job system when parallel is set. Each
+// recording only touches its own encoder and cache, so the result is the same in any order;
+// callers read the bundles back from their caches afterwards, in draw order.
+class BundleRecorder {
+public:
+    using Commands = std::function<void(WGPURenderBundleEncoder encoder)>;
+
+    explicit BundleRecorder(JobSystem& jobs) : jobs(jobs) {}
+
+    // The commands must capture everything they read by value, since they may run on another thread
+    void add(RenderBundleCache& cache, uint64_t key, const char* label, Commands commands);
+
+    // Records and clears the queued bundles; returns once all of them are finished
+    void record(WGPUDevice device, WGPUTextureFormat colorFormat);
+
+    // Only safe on devices that synchronize calls themselves (Dawn's ImplicitDeviceSynchronization)
+    bool parallel = false;
+
+    // Bundles recorded by the last record() call
+    size_t getLastRecordCount() const { return lastRecordCount; }
+
+private:
+    struct Recording {
+        RenderBundleCache* cache;
+        uint64_t key;
+        const char* label;
+        Commands commands;
+    };
+
+    JobSystem& jobs;
+    std::vector<Recording> recordings;
+    size_t lastRecordCount = 0;
+};
@@ -11,6 +11,7 @@ void Camera::setOrthographicProjection(float left, float right, float top, float
 
     // Flip Y for WebGPU coordinate system
     projectionMatrix[1][1] *= -1;
+    updateDerived();
 }
 
 void Camera::setPerspectiveProjection(float fovy, float aspect, float near, float far) {
@@ -25,6 +26,7 @@ void Camera::setPerspectiveProjection(float fovy, float aspect, float near, floa
 
     // Flip Y for WebGPU coordinate system
     projectionMatrix[1][1] *= -1;
+    updateDerived();
 }
 
 void Camera::updateView() {
@@ -66,16 +68,49 @@ void Camera::updateView() {
     inverseViewMatrix[3][0] = position.x;
     inverseViewMatrix[3][1] = position.y;
     inverseViewMatrix[3][2] = position.z;
+    updateDerived();
 }
 
 void Camera::setViewTarget(glm::vec3 position, glm::vec3 target, glm::vec3 up) {
     this->position = position;
     viewMatrix = glm::lookAt(position, target, up);
     inverseViewMatrix = glm::inverse(viewMatrix);
+    updateDerived();
 }
 
 void Camera::setViewYXZ(glm::vec3 position, glm::vec3 rotation) {
     this->position = position;
     this->rotation = rotation;
     updateView();
+}
+
+void Camera::updateDerived() {
+    viewProjectionMatrix = projectionMatrix * viewMatrix;
+    inverseViewProjectionMatrix = glm::inverse(viewProjectionMatrix);
+
+    // Gribb/Hartmann extraction from the rows of viewProj, with WebGPU's [0, 1] depth range
+    const glm::mat4& m = viewProjectionMatrix;
+    glm::vec4 row0{m[0][0], m[1][0], m[2][0], m[3][0]};
+    glm::vec4 row1{m[0][1], m[1][1], m[2][1], m[3][1]};
+    glm::vec4 row2{m[0][2], m[1][2], m[2][2], m[3][2]};
+    glm::vec4 row3{m[0][3], m[1][3], m[2][3], m[3][3]};
+
+    frustumPlanes[0] = row3 + row0;  // Left
+    frustumPlanes[1] = row3 - row0;  // Right
+    frustumPlanes[2] = row3 + row1;  // Bottom
+    frustumPlanes[3] = row3 - row1;  // Top
+    frustumPlanes[4] = row2;         // Near
+    frustumPlanes[5] = row3 - row2;  // Far
+    for (glm::vec4& plane : frustumPlanes) {
+        plane /= glm::length(glm::vec3(plane));
+    }
+
+    version++;
+}
+
+bool Camera::isSphereVisible(const glm::vec3& center, float radius) const {
+    for (const glm::vec4& plane : frustumPlanes) {
+        if (glm::dot(glm::vec3(plane), center) + plane.w < -radius) return false;
+    }
+    return true;
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
+#include <cstdint>
 
 class Camera {
 public:
@@ -14,18 +15,33 @@ public:
     const glm::mat4& getProjection() const { return projectionMatrix; }
     const glm::mat4& getView() const { return viewMatrix; }
     const glm::mat4& getInverseView() const { return inverseViewMatrix; }
+    const glm::mat4& getViewProjection() const { return viewProjectionMatrix; }
+    const glm::mat4& getInverseViewProjection() const { return inverseViewProjectionMatrix; }
     const glm::vec3& getPosition() const { return position; }
     const glm::vec3& getRotation() const { return rotation; }
 
     void setPosition(const glm::vec3& pos) { position = pos; updateView(); }
     void setRotation(const glm::vec3& rot) { rotation = rot; updateView(); }
 
+    // Normalized planes (xyz = inward normal, w = distance): left, right, bottom, top, near, far
+    const glm::vec4* getFrustumPlanes() const { return frustumPlanes; }
+    bool isSphereVisible(const glm::vec3& center, float radius) const;
+
+    // Bumped whenever the view or projection changes; compare against a stored value
+    // to skip uniform uploads and culling while the camera is still
+    uint64_t getVersion() const { return version; }
+
 private:
     void updateView();
+    void updateDerived();
 
     glm::mat4 projectionMatrix{1.f};
     glm::mat4 viewMatrix{1.f};
     glm::mat4 inverseViewMatrix{1.f};
+    glm::mat4 viewProjectionMatrix{1.f};
+    glm::mat4 inverseViewProjectionMatrix{1.f};
+    glm::vec4 frustumPlanes[6]{};
+    uint64_t version = 0;
     
     glm::vec3 position{};
     glm::vec3 rotation{};
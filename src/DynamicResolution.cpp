@@ -0,0 +1,218 @@
+#include "DynamicResolution.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+DynamicResolution::DynamicResolution(WGPUDevice device, PipelineManager& pipelines, ReleaseQueue& releaseQueue,
+                                     BufferAllocator& allocator, ReadbackManager& readback, WGPUTextureFormat outputFormat)
+    : device(device), pipelines(pipelines), releaseQueue(releaseQueue), allocator(allocator), readback(readback),
+      outputFormat(outputFormat) {
+    WGPUSamplerDescriptor samplerDesc = {};
+    samplerDesc.addressModeU = WGPUAddressMode_ClampToEdge;
+    samplerDesc.addressModeV = WGPUAddressMode_ClampToEdge;
+    samplerDesc.addressModeW = WGPUAddressMode_ClampToEdge;
+    samplerDesc.magFilter = WGPUFilterMode_Linear;
+    samplerDesc.minFilter = WGPUFilterMode_Linear;
+    samplerDesc.mipmapFilter = WGPUMipmapFilterMode_Nearest;
+    samplerDesc.maxAnisotropy = 1;
+    sampler.reset(wgpuDeviceCreateSampler(device, &samplerDesc));
+
+    createBindGroupLayout();
+    createPipeline();
+    createTimestampQueries();
+    enabled = timingSupported;
+}
+
+DynamicResolution::~DynamicResolution() {
+    // A readback still in flight must not call back into us
+    if (resolveBuffer) readback.cancel(resolveBuffer.get());
+}
+
+void DynamicResolution::createBindGroupLayout() {
+    WGPUBindGroupLayoutEntry entries[3] = {};
+
+    entries[0].binding = 0;
+    entries[0].visibility = WGPUShaderStage_Fragment;
+    entries[0].texture.sampleType = WGPUTextureSampleType_Float;
+    entries[0].texture.viewDimension = WGPUTextureViewDimension_2D;
+
+    entries[1].binding = 1;
+    entries[1].visibility = WGPUShaderStage_Fragment;
+    entries[1].sampler.type = WGPUSamplerBindingType_Filtering;
+
+    entries[2].binding = 2;
+    entries[2].visibility = WGPUShaderStage_Fragment;
+    entries[2].buffer.type = WGPUBufferBindingType_Uniform;
+    entries[2].buffer.hasDynamicOffset = true;  // Params live in the per-frame transient arena
+    entries[2].buffer.minBindingSize = sizeof(Params);
+
+    WGPUBindGroupLayoutDescriptor bglDesc = {};
+    bglDesc.entryCount = 3;
+    bglDesc.entries = entries;
+    bindGroupLayout.reset(wgpuDeviceCreateBindGroupLayout(device, &bglDesc));
+}
+
+void DynamicResolution::createPipeline() {
+    RenderPipelineDesc pipelineDesc;
+    pipelineDesc.label = "Scene upscale";
+    pipelineDesc.shaderName = "upscale";
+    pipelineDesc.bindGroupLayouts = {bindGroupLayout.get()};
+    pipelineDesc.colorFormat = outputFormat;
+
+    pipeline = pipelines.requestRenderPipeline(pipelineDesc);
+}
+
+void DynamicResolution::createTimestampQueries() {
+    timingSupported = wgpuDeviceHasFeature(device, WGPUFeatureName_TimestampQuery);
+    if (!timingSupported) return;
+
+    WGPUQuerySetDescriptor querySetDesc = {};
+    querySetDesc.label = "Scene pass timestamps";
+    querySetDesc.type = WGPUQueryType_Timestamp;
+    querySetDesc.count = 2;
+    querySet.reset(wgpuDeviceCreateQuerySet(device, &querySetDesc));
+
+    WGPUBufferDescriptor bufferDesc = {};
+    bufferDesc.label = "Scene pass timestamps";
+    bufferDesc.usage = WGPUBufferUsage_QueryResolve | WGPUBufferUsage_CopySrc;
+    bufferDesc.size = 2 * sizeof(uint64_t);
+    resolveBuffer.reset(wgpuDeviceCreateBuffer(device, &bufferDesc));
+
+    timestampWrites.querySet = querySet.get();
+    timestampWrites.beginningOfPassWriteIndex = 0;
+    timestampWrites.endOfPassWriteIndex = 1;
+}
+
+void DynamicResolution::resize(int width, int height) {
+    this->width = std::max(width, 1);
+    this->height = std::max(height, 1);
+    if (sceneTexture && this->width <= targetWidth && this->height <= targetHeight) return;
+
+    // Grow by at least a quarter so consecutive resize steps do not each reallocate
+    targetWidth = this->width > targetWidth ? std::max(this->width, targetWidth + targetWidth / 4) : targetWidth;
+    targetHeight = this->height > targetHeight ? std::max(this->height, targetHeight + targetHeight / 4) : targetHeight;
+    releaseTarget();
+    createTarget();
+}
+
+void DynamicResolution::trim() {
+    if (targetWidth == width && targetHeight == height) return;
+    targetWidth = width;
+    targetHeight = height;
+    releaseTarget();
+    createTarget();
+}
+
+void DynamicResolution::createTarget() {
+    WGPUTextureDescriptor textureDesc = {};
+    textureDesc.label = "Scene color";
+    textureDesc.usage = WGPUTextureUsage_RenderAttachment | WGPUTextureUsage_TextureBinding;
+    textureDesc.dimension = WGPUTextureDimension_2D;
+    textureDesc.size = {(uint32_t)targetWidth, (uint32_t)targetHeight, 1};
+    textureDesc.format = SCENE_COLOR_FORMAT;
+    textureDesc.mipLevelCount = 1;
+    textureDesc.sampleCount = 1;
+    sceneTexture.reset(wgpuDeviceCreateTexture(device, &textureDesc));
+    sceneView.reset(wgpuTextureCreateView(sceneTexture.get(), nullptr));
+
+    WGPUBindGroupEntry entries[3] = {};
+    entries[0].binding = 0;
+    entries[0].textureView = sceneView.get();
+    entries[1].binding = 1;
+    entries[1].sampler = sampler.get();
+    entries[2].binding = 2;
+    entries[2].buffer = allocator.getTransientBuffer();
+    entries[2].size = sizeof(Params);
+
+    WGPUBindGroupDescriptor bgDesc = {};
+    bgDesc.layout = bindGroupLayout.get();
+    bgDesc.entryCount = 3;
+    bgDesc.entries = entries;
+    bindGroup.reset(wgpuDeviceCreateBindGroup(device, &bgDesc));
+}
+
+void DynamicResolution::releaseTarget() {
+    // The previous target may still be in use by frames in flight
+    releaseQueue.retire(std::move(bindGroup));
+    releaseQueue.retire(std::move(sceneView));
+    releaseQueue.retire(std::move(sceneTexture));
+}
+
+int DynamicResolution::getSceneWidth() const {
+    return std::max(1, (int)std::lround(width * getScale()));
+}
+
+int DynamicResolution::getSceneHeight() const {
+    return std::max(1, (int)std::lround(height * getScale()));
+}
+
+// MARK: Controller
+
+void DynamicResolution::update() {
+    if (!enabled || !hasNewSample) return;
+    hasNewSample = false;
+
+    // Pixel cost scales with area, so the linear scale moves with the square root of the ratio
+    double ratio = budgetMs / std::max(gpuMs, 0.001);
+    if (std::abs(ratio - 1.0) < BUDGET_TOLERANCE) return;
+
+    float target = scale * (float)std::sqrt(ratio);
+    float step = std::clamp(target - scale, -MAX_SCALE_STEP, MAX_SCALE_STEP);
+    scale = std::clamp(scale + step, minScale, 1.0f);
+}
+
+void DynamicResolution::resolveTimestamps(WGPUCommandEncoder encoder) {
+    if (!timingSupported) return;
+
+    // Resolved every frame; the copy recorded next frame picks up the latest pair
+    wgpuCommandEncoderResolveQuerySet(encoder, querySet.get(), 0, 2, resolveBuffer.get(), 0);
+    if (readbackPending) return;
+
+    readbackPending = true;
+    readback.request(resolveBuffer.get(), 0, 2 * sizeof(uint64_t), [this](const void* data, uint64_t) {
+        readbackPending = false;
+        if (data) onTimestamps(data);
+    });
+}
+
+void DynamicResolution::onTimestamps(const void* data) {
+    uint64_t ticks[2];
+    memcpy(ticks, data, sizeof(ticks));
+    // Some implementations report a reset or out of order pair now and then
+    if (ticks[1] <= ticks[0]) return;
+
+    double ms = double(ticks[1] - ticks[0]) * 1e-6;
+    gpuMs += (ms - gpuMs) * GPU_TIME_SMOOTHING;
+    hasNewSample = true;
+}
+
+// MARK: Passes
+
+const WGPURenderPassTimestampWrites* DynamicResolution::getTimestampWrites() const {
+    return timingSupported ? &timestampWrites : nullptr;
+}
+
+void DynamicResolution::setSceneViewport(WGPURenderPassEncoder renderPass) const {
+    wgpuRenderPassEncoderSetViewport(renderPass, 0.0f, 0.0f,
+        (float)getSceneWidth(), (float)getSceneHeight(), 0.0f, 1.0f);
+    wgpuRenderPassEncoderSetScissorRect(renderPass, 0, 0, getSceneWidth(), getSceneHeight());
+}
+
+void DynamicResolution::upscale(WGPURenderPassEncoder renderPass) {
+    WGPURenderPipeline renderPipeline = pipelines.getRenderPipeline(pipeline);
+    if (!renderPipeline || !bindGroup) return;
+
+    // Sample the rendered region only, stopping half a texel short of its edge
+    Params params;
+    params.uvScale[0] = (float)getSceneWidth() / targetWidth;
+    params.uvScale[1] = (float)getSceneHeight() / targetHeight;
+    params.uvMax[0] = params.uvScale[0] - 0.5f / targetWidth;
+    params.uvMax[1] = params.uvScale[1] - 0.5f / targetHeight;
+    BufferAllocation paramsAllocation = allocator.allocateTransient(&params, sizeof(Params), BufferUsageKind::Uniform);
+    if (!paramsAllocation) return;
+    uint32_t paramsOffset = (uint32_t)paramsAllocation.offset;
+
+    wgpuRenderPassEncoderSetPipeline(renderPass, renderPipeline);
+    wgpuRenderPassEncoderSetBindGroup(renderPass, 0, bindGroup.get(), 1, &paramsOffset);
+    wgpuRenderPassEncoderDraw(renderPass, 3, 1, 0, 0);
+}
@@ -0,0 +1,107 @@
+#pragma once
+#include <webgpu/webgpu.h>
+#include "PipelineManager.h"
+#include "GpuHandle.h"
+#include "ReleaseQueue.h"
+#include "BufferAllocator.h"
+#include "ReadbackManager.h"
+
+// Renders the scene into an offscreen color target whose used region is scaled to keep the
+// measured GPU frame time inside a budget, then upscales it into the output pass.
+//
+// The target is allocated at (at least) full output size and the scene is drawn into the
+// top-left scale * size region through the pass viewport, so changing the scale never
+// reallocates. Growing the output reallocates with headroom and shrinking keeps the larger
+// target until trim(), so a drag-resize reallocates only a handful of times.
+// GPU time is the scene pass alone, measured with pass timestamps when the device has
+// TimestampQuery. Without it there is no GPU time to go by (submit-to-done callbacks measure
+// frame latency, which on a vsynced swap chain never drops below the refresh interval), so the
+// controller starts disabled and cannot be enabled.
+class DynamicResolution {
+public:
+    DynamicResolution(WGPUDevice device, PipelineManager& pipelines, ReleaseQueue& releaseQueue,
+                      BufferAllocator& allocator, ReadbackManager& readback, WGPUTextureFormat outputFormat);
+    ~DynamicResolution();
+
+    // Sets the output size, growing the scene target if it no longer fits
+    void resize(int width, int height);
+
+    // Shrinks the scene target to the output size; call once resizing has settled
+    void trim();
+
+    // Feeds the latest GPU timing into the controller; call once per frame before rendering
+    void update();
+
+    // Scene pass color target, timestamp writes (nullptr without TimestampQuery) and the
+    // viewport to draw it with
+    WGPUTextureView getSceneView() const { return sceneView.get(); }
+    const WGPURenderPassTimestampWrites* getTimestampWrites() const;
+    void setSceneViewport(WGPURenderPassEncoder renderPass) const;
+
+    // Resolves the scene pass timestamps and reads them back if no readback is in flight;
+    // call after the scene pass has ended
+    void resolveTimestamps(WGPUCommandEncoder encoder);
+
+    // Draws the scene region stretched over the whole output pass
+    void upscale(WGPURenderPassEncoder renderPass);
+
+    bool enabled = false;  // Defaults to isTimingSupported()
+    float budgetMs = 16.6f;
+    float minScale = 0.5f;
+
+    float getScale() const { return enabled ? scale : 1.0f; }
+    bool isTimingSupported() const { return timingSupported; }
+    double getGpuMs() const { return gpuMs; }
+    int getSceneWidth() const;
+    int getSceneHeight() const;
+
+private:
+    struct Params {
+        float uvScale[2];
+        float uvMax[2];
+    };
+
+    void createTarget();
+    void releaseTarget();
+    void createBindGroupLayout();
+    void createPipeline();
+    void createTimestampQueries();
+    void onTimestamps(const void* data);
+
+    // Controller tuning: smoothing of the measured time, dead band around the budget
+    // and how far the scale may move per frame
+    static constexpr double GPU_TIME_SMOOTHING = 0.1;
+    static constexpr double BUDGET_TOLERANCE = 0.05;
+    static constexpr float MAX_SCALE_STEP = 0.02f;
+
+    WGPUDevice device;
+    PipelineManager& pipelines;
+    ReleaseQueue& releaseQueue;
+    BufferAllocator& allocator;
+    ReadbackManager& readback;
+    WGPUTextureFormat outputFormat;
+    PipelineManager::Handle pipeline = PipelineManager::INVALID_HANDLE;
+
+    GpuTexture sceneTexture;
+    GpuTextureView sceneView;
+    GpuSampler sampler;
+    GpuBindGroupLayout bindGroupLayout;
+    GpuBindGroup bindGroup;
+
+    // Output size, and the allocated size of the scene target which may be larger
+    int width = 0;
+    int height = 0;
+    int targetWidth = 0;
+    int targetHeight = 0;
+    float scale = 1.0f;
+
+    // Begin and end of the scene pass, resolved to ticks (nanoseconds) in resolveBuffer
+    bool timingSupported = false;
+    GpuQuerySet querySet;
+    GpuBuffer resolveBuffer;
+    WGPURenderPassTimestampWrites timestampWrites = {};
+    bool readbackPending = false;
+
+    double gpuMs = 0.0;
+    bool hasNewSample = false;
+};
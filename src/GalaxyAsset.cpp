@@ -0,0 +1,285 @@
+#include "GalaxyAsset.h"
+#include <stdio.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#ifdef __EMSCRIPTEN__
+#include <emscripten/fetch.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+GalaxyAsset::GalaxyAsset(Callbacks callbacks) : callbacks(std::move(callbacks)) {}
+
+GalaxyAsset::~GalaxyAsset() {
+    close();
+}
+
+// MARK: Loading
+
+void GalaxyAsset::load(const char* path) {
+#ifdef __EMSCRIPTEN__
+    // STREAM_DATA hands over the body piece by piece where the browser supports it; elsewhere
+    // the whole body arrives in onsuccess and the chunks are reported all at once
+    emscripten_fetch_attr_t attr;
+    emscripten_fetch_attr_init(&attr);
+    strcpy(attr.requestMethod, "GET");
+    attr.attributes = EMSCRIPTEN_FETCH_LOAD_TO_MEMORY | EMSCRIPTEN_FETCH_STREAM_DATA;
+    attr.userData = this;
+    attr.onprogress = [](emscripten_fetch_t* fetch) {
+        auto* asset = static_cast<GalaxyAsset*>(fetch->userData);
+        if (!asset) return;
+        if (fetch->totalBytes > 0) asset->received.reserve((size_t)fetch->totalBytes);
+        asset->receive(reinterpret_cast<const uint8_t*>(fetch->data), (size_t)fetch->dataOffset, (size_t)fetch->numBytes);
+    };
+    attr.onsuccess = [](emscripten_fetch_t* fetch) {
+        auto* asset = static_cast<GalaxyAsset*>(fetch->userData);
+        if (!asset) return;
+        asset->receive(reinterpret_cast<const uint8_t*>(fetch->data), (size_t)fetch->dataOffset, (size_t)fetch->numBytes);
+        asset->close();
+        asset->finish();
+    };
+    attr.onerror = [](emscripten_fetch_t* fetch) {
+        auto* asset = static_cast<GalaxyAsset*>(fetch->userData);
+        if (!asset) return;
+        printf("Failed to fetch galaxy asset %s: HTTP %d\n", fetch->url, fetch->status);
+        asset->close();
+        asset->fail("download failed");
+    };
+    fetch = emscripten_fetch(&attr, path);
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        printf("Failed to open galaxy asset %s\n", path);
+        fail("file not found");
+        return;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0) {
+        ::close(fd);
+        fail("empty file");
+        return;
+    }
+    mapping = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        mapping = nullptr;
+        fail("mmap failed");
+        return;
+    }
+    // Chunks are read once, front to back
+    madvise(mapping, (size_t)info.st_size, MADV_SEQUENTIAL);
+    data = static_cast<const uint8_t*>(mapping);
+    size = (size_t)info.st_size;
+    parse();
+    finish();
+#endif
+}
+
+void GalaxyAsset::close() {
+#ifdef __EMSCRIPTEN__
+    if (fetch) {
+        // Closing an unfinished fetch reports it as failed; make that a no-op
+        fetch->userData = nullptr;
+        emscripten_fetch_close(fetch);
+        fetch = nullptr;
+    }
+#else
+    if (mapping) {
+        munmap(mapping, size);
+        mapping = nullptr;
+        data = nullptr;
+    }
+#endif
+}
+
+void GalaxyAsset::receive(const uint8_t* bytes, size_t offset, size_t count) {
+    // Pieces may repeat what already arrived (onsuccess without streaming support)
+    if (!bytes || failed || offset > received.size() || offset + count <= received.size()) return;
+    size_t skip = received.size() - offset;
+    received.insert(received.end(), bytes + skip, bytes + count);
+    data = received.data();
+    size = received.size();
+    parse();
+}
+
+void GalaxyAsset::parse() {
+    if (failed) return;
+
+    if (!headerParsed) {
+        if (size < sizeof(GalaxyAssetHeader)) return;
+        memcpy(&header, data, sizeof(header));
+        if (memcmp(header.magic, ASSET_MAGIC, sizeof(header.magic)) != 0 || header.version != ASSET_VERSION) {
+            fail("not a galaxy asset of this version");
+            return;
+        }
+        if (header.chunkPoints == 0 || header.ellipseCount == 0 ||
+            header.chunkCount != (header.pointCount + header.chunkPoints - 1) / header.chunkPoints) {
+            fail("inconsistent header");
+            return;
+        }
+
+        size_t tablesSize = sizeof(GalaxyAssetHeader) + header.ellipseCount * (sizeof(EllipseParams) + sizeof(uint32_t)) +
+                            size_t(header.chunkCount) * sizeof(GalaxyAssetChunk);
+        if (size < tablesSize) return;
+
+        const uint8_t* cursor = data + sizeof(GalaxyAssetHeader);
+        ellipses.resize(header.ellipseCount);
+        memcpy(ellipses.data(), cursor, sizeof(EllipseParams) * header.ellipseCount);
+        cursor += sizeof(EllipseParams) * header.ellipseCount;
+        populations.resize(header.ellipseCount);
+        memcpy(populations.data(), cursor, sizeof(uint32_t) * header.ellipseCount);
+        cursor += sizeof(uint32_t) * header.ellipseCount;
+        chunks.resize(header.chunkCount);
+        memcpy(chunks.data(), cursor, sizeof(GalaxyAssetChunk) * header.chunkCount);
+
+        // Payloads follow the tables in order, so each chunk is complete once the stream passes its end
+        uint64_t end = tablesSize;
+        for (uint32_t i = 0; i < header.chunkCount; i++) {
+            uint32_t expected = std::min(header.chunkPoints, header.pointCount - i * header.chunkPoints);
+            if (chunks[i].offset < end || chunks[i].pointCount != expected) {
+                fail("inconsistent chunk table");
+                return;
+            }
+            end = chunks[i].offset + chunks[i].size;
+        }
+
+        headerParsed = true;
+        if (callbacks.onHeader && !callbacks.onHeader(*this)) {
+            fail("rejected by the loader");
+            return;
+        }
+    }
+
+    while (nextChunk < header.chunkCount && chunks[nextChunk].offset + chunks[nextChunk].size <= size) {
+        uint32_t index = nextChunk++;
+        if (callbacks.onChunk) callbacks.onChunk(index);
+        if (failed) return;
+    }
+}
+
+void GalaxyAsset::finish() {
+    if (failed) return;
+    if (!headerParsed || nextChunk < header.chunkCount) {
+        fail("file is truncated");
+        return;
+    }
+    if (callbacks.onComplete) callbacks.onComplete();
+}
+
+void GalaxyAsset::fail(const char* reason) {
+    if (failed) return;
+    failed = true;
+    printf("Galaxy asset rejected: %s\n", reason);
+    if (callbacks.onFailed) callbacks.onFailed(reason);
+}
+
+// MARK: Decoding
+
+uint16_t GalaxyAsset::quantize(float value, float min, float max) {
+    if (!(max > min)) return 0;
+    float normalized = std::clamp((value - min) / (max - min), 0.0f, 1.0f);
+    return (uint16_t)std::lround(normalized * 65535.0f);
+}
+
+float GalaxyAsset::dequantize(uint16_t value, float min, float max) {
+    return min + (max - min) * (value * (1.0f / 65535.0f));
+}
+
+bool GalaxyAsset::decode(uint32_t chunkIndex, uint32_t first, uint32_t count, Point* out) {
+    if (!headerParsed || chunkIndex >= nextChunk || first + count > chunks[chunkIndex].pointCount) return false;
+    if (chunkIndex != unpackedChunk && !unpack(chunkIndex)) return false;
+
+    const GalaxyAssetChunk& chunk = chunks[chunkIndex];
+    for (uint32_t n = 0; n < count; n++) {
+        uint32_t i = first + n;
+        Point& point = out[n];
+        point = {};
+        if (unpackedEllipses[i] == ASSET_INACTIVE) {
+            point.ellipse = INACTIVE_POINT;
+            continue;
+        }
+        point.ellipse = unpackedEllipses[i];
+        for (int axis = 0; axis < 3; axis++) {
+            point.position[axis] = dequantize(unpackedFields[axis][i], chunk.positionMin[axis], chunk.positionMax[axis]);
+            point.velocity[axis] = dequantize(unpackedFields[3 + axis][i], chunk.velocityMin[axis], chunk.velocityMax[axis]);
+        }
+    }
+    return true;
+}
+
+bool GalaxyAsset::unpack(uint32_t chunkIndex) {
+    const GalaxyAssetChunk& chunk = chunks[chunkIndex];
+    const uint8_t* payload = data + chunk.offset;
+    size_t rawSize = size_t(chunk.pointCount) * BYTES_PER_POINT;
+
+    if (header.flags & ASSET_ENTROPY_CODED) {
+        scratch.resize(rawSize);
+        if (!decodeRans(payload, chunk.size, scratch.data(), rawSize)) return false;
+        payload = scratch.data();
+    } else if (chunk.size != rawSize) {
+        return false;
+    }
+
+    // Undo the deltas; inactive slots repeat the previous value and decode to zeros
+    uint32_t n = chunk.pointCount;
+    unpackedEllipses.assign(payload, payload + n);
+    for (int field = 0; field < FIELD_COUNT; field++) {
+        const uint8_t* lo = payload + n + size_t(field) * 2 * n;
+        const uint8_t* hi = lo + n;
+        std::vector<uint16_t>& values = unpackedFields[field];
+        values.resize(n);
+        uint16_t previous = 0;
+        for (uint32_t i = 0; i < n; i++) {
+            previous = uint16_t(previous + (lo[i] | (hi[i] << 8)));
+            values[i] = previous;
+        }
+    }
+    for (uint32_t i = 0; i < n; i++) {
+        if (unpackedEllipses[i] != ASSET_INACTIVE && unpackedEllipses[i] >= header.ellipseCount) return false;
+    }
+    unpackedChunk = chunkIndex;
+    return true;
+}
+
+// Order-0 rANS with byte-wise renormalization (Giesen's rans_byte). The payload starts with the
+// 256 symbol frequencies, scaled to sum to 1 << RANS_SCALE_BITS, then the encoder's final state.
+bool GalaxyAsset::decodeRans(const uint8_t* in, size_t inSize, uint8_t* out, size_t outSize) {
+    constexpr uint32_t total = 1u << RANS_SCALE_BITS;
+    if (inSize < 256 * sizeof(uint16_t) + 4) return false;
+
+    uint16_t freqs[256];
+    uint32_t starts[256];
+    memcpy(freqs, in, sizeof(freqs));
+    uint32_t start = 0;
+    for (int symbol = 0; symbol < 256; symbol++) {
+        starts[symbol] = start;
+        start += freqs[symbol];
+    }
+    if (start != total) return false;
+
+    uint8_t symbols[total];
+    for (int symbol = 0; symbol < 256; symbol++) {
+        memset(symbols + starts[symbol], symbol, freqs[symbol]);
+    }
+
+    const uint8_t* cursor = in + sizeof(freqs);
+    const uint8_t* end = in + inSize;
+    uint32_t state = cursor[0] | (cursor[1] << 8) | (cursor[2] << 16) | (uint32_t(cursor[3]) << 24);
+    cursor += 4;
+
+    for (size_t i = 0; i < outSize; i++) {
+        uint8_t symbol = symbols[state & (total - 1)];
+        out[i] = symbol;
+        state = freqs[symbol] * (state >> RANS_SCALE_BITS) + (state & (total - 1)) - starts[symbol];
+        while (state < RANS_L) {
+            if (cursor == end) return false;
+            state = (state << 8) | *cursor++;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "GalaxyGenerator.h"
+
+#ifdef __EMSCRIPTEN__
+struct emscripten_fetch_t;
+#endif
+
+// Baked initial conditions (.gxic), written by tools/bake_galaxy.cpp. All fields little endian:
+//
+//   GalaxyAssetHeader
+//   EllipseParams[ellipseCount]
+//   uint32_t populations[ellipseCount]
+//   GalaxyAssetChunk[chunkCount]
+//   chunk payloads, in slot order
+//
+// A chunk covers chunkPoints consecutive slots (fewer for the last). Its payload is one ellipse
+// byte per point (ASSET_INACTIVE for unused slots) followed by the six position and velocity
+// fields, each quantized to 16 bits within the chunk's bounds, delta coded from the previous
+// active point and stored as a plane of low bytes then a plane of high bytes: 13 bytes a point.
+// With ASSET_ENTROPY_CODED that payload is order-0 rANS coded behind its frequency table.
+struct GalaxyAssetHeader {
+    char magic[4];              // ASSET_MAGIC
+    uint32_t version;           // ASSET_VERSION
+    uint32_t flags;
+    uint32_t pointCount;        // Slots, active or not
+    uint32_t chunkPoints;
+    uint32_t chunkCount;
+    uint32_t ellipseCount;
+    uint32_t ellipseCapacity;   // Slots per ellipse
+};
+
+struct GalaxyAssetChunk {
+    uint64_t offset;  // Of the payload, from the start of the file
+    uint32_t size;    // Of the payload as stored
+    uint32_t pointCount;
+    // Quantization range of the chunk's active points
+    float positionMin[3];
+    float positionMax[3];
+    float velocityMin[3];
+    float velocityMax[3];
+};
+
+static_assert(sizeof(GalaxyAssetHeader) == 32, "GalaxyAssetHeader is a file format");
+static_assert(sizeof(GalaxyAssetChunk) == 64, "GalaxyAssetChunk is a file format");
+static_assert(sizeof(EllipseParams) == 16, "EllipseParams is stored in the file as is");
+
+// Reads a .gxic file and decodes its chunks on request.
+//
+// Desktop maps the file, so chunks decode straight from the page cache; the web streams it
+// with fetch and reports each chunk as soon as all of its bytes have arrived, so uploads start
+// before the download ends. Callbacks run on the thread that called load(), from inside load()
+// on desktop and from the browser's event loop on the web.
+class GalaxyAsset {
+public:
+    static constexpr char ASSET_MAGIC[4] = {'G', 'X', 'I', 'C'};
+    static constexpr uint32_t ASSET_VERSION = 1;
+    static constexpr uint32_t ASSET_ENTROPY_CODED = 1u << 0;
+    static constexpr uint8_t ASSET_INACTIVE = 0xFF;
+    static constexpr int FIELD_COUNT = 6;                       // position xyz, velocity xyz
+    static constexpr int BYTES_PER_POINT = 1 + FIELD_COUNT * 2;
+
+    // rANS parameters, shared with the encoder in tools/bake_galaxy.cpp
+    static constexpr uint32_t RANS_SCALE_BITS = 12;
+    static constexpr uint32_t RANS_L = 1u << 23;  // Lower bound of the normalized state
+
+    struct Callbacks {
+        // Header, ellipses and chunk table are valid; false rejects the asset
+        std::function<bool(const GalaxyAsset& asset)> onHeader;
+        std::function<void(uint32_t chunkIndex)> onChunk;        // Every byte of the chunk has arrived
+        std::function<void()> onComplete;
+        std::function<void(const char* reason)> onFailed;        // No further callbacks follow
+    };
+
+    explicit GalaxyAsset(Callbacks callbacks);
+    ~GalaxyAsset();
+
+    GalaxyAsset(const GalaxyAsset&) = delete;
+    GalaxyAsset& operator=(const GalaxyAsset&) = delete;
+
+    void load(const char* path);
+
+    const GalaxyAssetHeader& getHeader() const { return header; }
+    const EllipseParams* getEllipses() const { return ellipses.data(); }
+    const uint32_t* getPopulations() const { return populations.data(); }
+    const GalaxyAssetChunk& getChunk(uint32_t index) const { return chunks[index]; }
+    size_t getFileSize() const { return size; }
+
+    // Writes count points starting at point first of the chunk to out. The chunk's fields are
+    // decoded once and kept, so a chunk split across several calls is only unpacked once.
+    // False if its payload is corrupt.
+    bool decode(uint32_t chunkIndex, uint32_t first, uint32_t count, Point* out);
+
+    // Payload helpers, shared with the baker
+    static uint16_t quantize(float value, float min, float max);
+    static float dequantize(uint16_t value, float min, float max);
+
+private:
+    void receive(const uint8_t* bytes, size_t offset, size_t count);
+    void parse();
+    void finish();
+    void fail(const char* reason);
+    void close();
+
+    bool unpack(uint32_t chunkIndex);
+    static bool decodeRans(const uint8_t* in, size_t inSize, uint8_t* out, size_t outSize);
+
+    Callbacks callbacks;
+    bool headerParsed = false;
+    bool failed = false;
+    uint32_t nextChunk = 0;  // First chunk not yet reported
+
+    // File contents: the mapping on desktop, the bytes received so far on the web
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+    std::vector<uint8_t> received;
+#ifdef __EMSCRIPTEN__
+    emscripten_fetch_t* fetch = nullptr;
+#else
+    void* mapping = nullptr;
+#endif
+
+    GalaxyAssetHeader header = {};
+    std::vector<EllipseParams> ellipses;
+    std::vector<uint32_t> populations;
+    std::vector<GalaxyAssetChunk> chunks;
+
+    // Last unpacked chunk: ellipse bytes and absolute quantized fields
+    uint32_t unpackedChunk = UINT32_MAX;
+    std::vector<uint8_t> unpackedEllipses;
+    std::vector<uint16_t> unpackedFields[FIELD_COUNT];
+    std::vector<uint8_t> scratch;
+};
@@ -0,0 +1,77 @@
+#include "GalaxyGenerator.h"
+#include <algorithm>
+#include <cmath>
+
+void GalaxyGenerator::initEllipses(std::vector<EllipseParams>& params, std::vector<uint32_t>& populations) {
+    params.resize(MAX_ELLIPSES);
+    populations.resize(MAX_ELLIPSES);
+
+    int starsPerEllipse = NUM_POINTS / MAX_ELLIPSES;
+    float currentEllipseSize = 1.83f; // Base radius from galaxy system
+    float tiltIncrement = 0.16f;      // From galaxy system
+
+    for (int ellipseIndex = 0; ellipseIndex < MAX_ELLIPSES; ellipseIndex++) {
+        params[ellipseIndex].majorAxis = currentEllipseSize;
+        params[ellipseIndex].minorAxis = currentEllipseSize * 0.8f; // eccentricity of 0.8
+        params[ellipseIndex].tiltAngle = ellipseIndex * tiltIncrement;
+
+        // The last ellipse takes the remainder
+        populations[ellipseIndex] = (ellipseIndex == MAX_ELLIPSES - 1)
+            ? NUM_POINTS - starsPerEllipse * (MAX_ELLIPSES - 1) : starsPerEllipse;
+
+        currentEllipseSize += 0.5f; // Increment size for next ellipse
+    }
+}
+
+Point GalaxyGenerator::generatePoint(int i, const EllipseParams* ellipses, const uint32_t* populations) {
+    int ellipseIndex = i / ELLIPSE_CAPACITY;
+    int slot = i % ELLIPSE_CAPACITY;
+    const EllipseParams& params = ellipses[ellipseIndex];
+    int starsInThisEllipse = populations[ellipseIndex];
+
+    Point point = {};
+    if (slot >= starsInThisEllipse) {
+        point.ellipse = INACTIVE_POINT;
+        return point;
+    }
+
+    float angleStep = (2.0f * 3.14159f) / std::max(starsInThisEllipse, 1);
+    float currentEllipseSize = params.majorAxis;
+    float currentTilt = params.tiltAngle;
+    float t = slot * angleStep;
+
+    // Base position calculation
+    float x = currentEllipseSize * cos(t) * cos(currentTilt);
+    float z = currentEllipseSize * cos(t) * sin(currentTilt);
+
+    // Calculate height using rough approximation of de Vaucouleurs's Law
+    float radius = sqrt(x * x + z * z) + 0.0001f;
+    float baseHeight = 0.5f * exp(-1.4f * pow(radius/3.66f, 0.25f));
+    float randomizedHeight = baseHeight * (hash(i) * 2.0f - 1.0f);
+
+    // Random offset for more natural distribution
+    float randRadius = hash(i * 12.345f) * currentEllipseSize;
+    float randAngle = hash(i * 67.890f) * 2.0f * 3.14159f;
+
+    // Calculate offsets
+    float offsetX = randRadius * cos(randAngle);
+    float offsetZ = randRadius * sin(randAngle);
+
+    // Set final position
+    point.position[0] = x + offsetX;
+    point.position[1] = randomizedHeight;
+    point.position[2] = z + offsetZ;
+    point.ellipse = ellipseIndex;
+
+    // Store parameters in velocity for compute shader
+    point.velocity[0] = t;                // angle
+    point.velocity[1] = randomizedHeight; // stored height
+    point.velocity[2] = randRadius;       // radial offset
+    return point;
+}
+
+float GalaxyGenerator::hash(uint32_t n) {
+    n = (n << 13U) ^ n;
+    n = n * (n * n * 15731U + 0x789221U) + 0x137631U;
+    return float(n & 0x7fffffffU) / float(0x7fffffff);
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+struct Point {
+    alignas(16) float position[3];  // x, y, z position
+    uint32_t ellipse;               // Owning ellipse, or INACTIVE_POINT for an unused slot
+    alignas(16) float velocity[3];  // x, y, z velocity
+};
+
+constexpr uint32_t INACTIVE_POINT = 0xFFFFFFFFu;
+
+// Shape of one orbit; mirrors EllipseParams in galaxy_update.wgsl
+struct EllipseParams {
+    float majorAxis;
+    float minorAxis;
+    float tiltAngle;
+    float speed = 1.0f;  // Multiplier on the orbital speed
+};
+
+// Initial galaxy on the CPU, shared by PointWebSystem and tools/bake_galaxy.cpp. Every star is
+// a pure function of its slot and its ellipse, so any range of slots can be generated on its
+// own, in any order and on any thread.
+class GalaxyGenerator {
+public:
+    static constexpr int NUM_POINTS = 100000;  // Initial population across all ellipses
+    static constexpr int MAX_ELLIPSES = 30;
+
+    // Every ellipse owns a fixed slot range, so its stars can be regenerated and uploaded
+    // without moving anyone else's; slots beyond its population are inactive
+    static constexpr int ELLIPSE_CAPACITY = 2 * (NUM_POINTS / MAX_ELLIPSES);
+    static constexpr int POINT_CAPACITY = ELLIPSE_CAPACITY * MAX_ELLIPSES;
+
+    // Default preset: MAX_ELLIPSES concentric, progressively tilted ellipses sharing NUM_POINTS
+    static void initEllipses(std::vector<EllipseParams>& params, std::vector<uint32_t>& populations);
+
+    // Star in slot index of the galaxy described by params and populations (MAX_ELLIPSES each)
+    static Point generatePoint(int index, const EllipseParams* params, const uint32_t* populations);
+
+    // Deterministic value in [0, 1]
+    static float hash(uint32_t n);
+};
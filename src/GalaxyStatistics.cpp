@@ -0,0 +1,164 @@
+#include "GalaxyStatistics.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+GalaxyStatistics::GalaxyStatistics(WGPUDevice device, PipelineManager& pipelines, BufferAllocator& allocator,
+                                   ReadbackManager& readback, uint32_t pointCount, float timeStep)
+    : device(device), pipelines(pipelines), allocator(allocator), readback(readback),
+      pointCount(pointCount), timeStep(timeStep),
+      energyHistory(HISTORY_LENGTH, 0.0f), angularMomentumHistory(HISTORY_LENGTH, 0.0f) {
+    // Enough workgroups to keep the GPU busy; each loops over the rest of the points
+    partialCount = std::min(MAX_PARTIALS, (pointCount + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE);
+
+    WGPUBufferDescriptor partialsDesc = {};
+    partialsDesc.label = "Galaxy statistics partials";
+    partialsDesc.size = sizeof(Partial) * partialCount;
+    partialsDesc.usage = WGPUBufferUsage_Storage;
+    partialsBuffer.reset(wgpuDeviceCreateBuffer(device, &partialsDesc));
+
+    WGPUBufferDescriptor resultDesc = {};
+    resultDesc.label = "Galaxy statistics";
+    resultDesc.size = sizeof(Partial);
+    resultDesc.usage = WGPUBufferUsage_Storage | WGPUBufferUsage_CopySrc;
+    resultBuffer.reset(wgpuDeviceCreateBuffer(device, &resultDesc));
+
+    paramsBuffer = allocator.allocate(sizeof(Params));
+
+    createBindGroupLayout();
+    createPipelines();
+}
+
+GalaxyStatistics::~GalaxyStatistics() {
+    readback.cancel(resultBuffer.get());
+    allocator.free(paramsBuffer);
+}
+
+void GalaxyStatistics::createBindGroupLayout() {
+    WGPUBindGroupLayoutEntry entries[5] = {};
+    // Previous and current simulation step
+    for (int i = 0; i < 2; i++) {
+        entries[i].binding = i;
+        entries[i].visibility = WGPUShaderStage_Compute;
+        entries[i].buffer.type = WGPUBufferBindingType_ReadOnlyStorage;
+    }
+    // Per-workgroup partials and the final record
+    for (int i = 2; i < 4; i++) {
+        entries[i].binding = i;
+        entries[i].visibility = WGPUShaderStage_Compute;
+        entries[i].buffer.type = WGPUBufferBindingType_Storage;
+    }
+    entries[4].binding = 4;
+    entries[4].visibility = WGPUShaderStage_Compute;
+    entries[4].buffer.type = WGPUBufferBindingType_Uniform;
+    entries[4].buffer.minBindingSize = sizeof(Params);
+
+    WGPUBindGroupLayoutDescriptor layoutDesc = {};
+    layoutDesc.entryCount = 5;
+    layoutDesc.entries = entries;
+    bindGroupLayout.reset(wgpuDeviceCreateBindGroupLayout(device, &layoutDesc));
+}
+
+void GalaxyStatistics::createPipelines() {
+    ComputePipelineDesc pipelineDesc;
+    pipelineDesc.shaderName = "galaxy_stats";
+    pipelineDesc.bindGroupLayouts = {bindGroupLayout.get()};
+
+    pipelineDesc.label = "Galaxy statistics partials";
+    pipelineDesc.entryPoint = "reduce_partials";
+    partialsPipeline = pipelines.requestComputePipeline(pipelineDesc);
+
+    pipelineDesc.label = "Galaxy statistics final";
+    pipelineDesc.entryPoint = "reduce_final";
+    finalPipeline = pipelines.requestComputePipeline(pipelineDesc);
+}
+
+void GalaxyStatistics::setParticleBuffers(WGPUBuffer bufferA, WGPUBuffer bufferB, uint64_t size) {
+    auto createBindGroup = [&](WGPUBuffer previous, WGPUBuffer current) {
+        WGPUBindGroupEntry entries[5] = {};
+        entries[0].binding = 0;
+        entries[0].buffer = previous;
+        entries[0].size = size;
+        entries[1].binding = 1;
+        entries[1].buffer = current;
+        entries[1].size = size;
+        entries[2].binding = 2;
+        entries[2].buffer = partialsBuffer.get();
+        entries[2].size = sizeof(Partial) * partialCount;
+        entries[3].binding = 3;
+        entries[3].buffer = resultBuffer.get();
+        entries[3].size = sizeof(Partial);
+        entries[4].binding = 4;
+        entries[4].buffer = paramsBuffer.buffer;
+        entries[4].offset = paramsBuffer.offset;
+        entries[4].size = sizeof(Params);
+
+        WGPUBindGroupDescriptor bindGroupDesc = {};
+        bindGroupDesc.layout = bindGroupLayout.get();
+        bindGroupDesc.entryCount = 5;
+        bindGroupDesc.entries = entries;
+        return GpuBindGroup(wgpuDeviceCreateBindGroup(device, &bindGroupDesc));
+    };
+
+    bindGroupAToB = createBindGroup(bufferA, bufferB);
+    bindGroupBToA = createBindGroup(bufferB, bufferA);
+}
+
+// MARK: Frame
+
+void GalaxyStatistics::dispatch(WGPUComputePassEncoder computePass, bool aToB) {
+    if (!enabled || !bindGroupAToB) return;
+    WGPUComputePipeline partials = pipelines.getComputePipeline(partialsPipeline);
+    WGPUComputePipeline total = pipelines.getComputePipeline(finalPipeline);
+    if (!partials || !total) return;
+
+    if (histogramRadius != uploadedRadius) {
+        uploadedRadius = histogramRadius;
+        Params params = {histogramRadius, timeStep, pointCount, partialCount};
+        allocator.write(paramsBuffer, &params, sizeof(Params));
+    }
+
+    WGPUBindGroup bindGroup = aToB ? bindGroupAToB.get() : bindGroupBToA.get();
+    wgpuComputePassEncoderSetBindGroup(computePass, 0, bindGroup, 0, nullptr);
+    wgpuComputePassEncoderSetPipeline(computePass, partials);
+    wgpuComputePassEncoderDispatchWorkgroups(computePass, partialCount, 1, 1);
+    wgpuComputePassEncoderSetPipeline(computePass, total);
+    wgpuComputePassEncoderDispatchWorkgroups(computePass, 1, 1, 1);
+
+    // The copy is recorded at the start of the next frame, after this frame's result is written
+    if (readbackPending) return;
+    readbackPending = true;
+    readback.request(resultBuffer.get(), 0, sizeof(Partial), [this](const void* data, uint64_t size) {
+        readbackPending = false;
+        if (data && size == sizeof(Partial)) onResult(*static_cast<const Partial*>(data));
+    });
+}
+
+void GalaxyStatistics::onResult(const Partial& result) {
+    float count = result.sumPosition[3];
+    if (count <= 0.0f) return;
+
+    glm::vec3 sumPosition(result.sumPosition[0], result.sumPosition[1], result.sumPosition[2]);
+    glm::vec3 sumVelocity(result.sumVelocity[0], result.sumVelocity[1], result.sumVelocity[2]);
+    glm::vec3 sumVelocitySq(result.sumVelocitySq[0], result.sumVelocitySq[1], result.sumVelocitySq[2]);
+    glm::vec3 angularMomentum(result.angularMomentum[0], result.angularMomentum[1], result.angularMomentum[2]);
+
+    summary.count = (uint32_t)count;
+    summary.centerOfMass = sumPosition / count;
+    summary.boundsMin = glm::vec3(result.minPosition[0], result.minPosition[1], result.minPosition[2]);
+    summary.boundsMax = glm::vec3(result.maxPosition[0], result.maxPosition[1], result.maxPosition[2]);
+    summary.meanVelocity = sumVelocity / count;
+    summary.velocityDispersion = glm::sqrt(glm::max(
+        sumVelocitySq / count - summary.meanVelocity * summary.meanVelocity, glm::vec3(0.0f)));
+    // The GPU sums r x v about the origin; shift it to the centre of mass
+    summary.angularMomentum = angularMomentum - count * glm::cross(summary.centerOfMass, summary.meanVelocity);
+    summary.kineticEnergy = 0.5f * result.sumVelocity[3];
+    for (int i = 0; i < HISTOGRAM_BINS; i++) {
+        summary.radialProfile[i] = (float)result.histogram[i];
+    }
+    summaryCount++;
+
+    energyHistory[historyOffset] = summary.kineticEnergy;
+    angularMomentumHistory[historyOffset] = glm::length(summary.angularMomentum);
+    historyOffset = (historyOffset + 1) % HISTORY_LENGTH;
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <webgpu/webgpu.h>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "PipelineManager.h"
+#include "GpuHandle.h"
+#include "BufferAllocator.h"
+#include "ReadbackManager.h"
+
+// Summarises the simulated particles on the GPU every frame.
+//
+// Two compute dispatches (shaders/galaxy_stats.wgsl) reduce both ping-pong buffers to one
+// 224-byte record, which is read back asynchronously; only one readback is in flight at a time,
+// so the summary trails the simulation by a few frames. Velocities are the difference between
+// the two buffers over one simulation step, as the particles do not store them.
+class GalaxyStatistics {
+public:
+    static constexpr int HISTOGRAM_BINS = 32;
+    static constexpr int HISTORY_LENGTH = 240;
+
+    struct Summary {
+        uint32_t count = 0;
+        glm::vec3 centerOfMass = glm::vec3(0.0f);
+        glm::vec3 boundsMin = glm::vec3(0.0f);
+        glm::vec3 boundsMax = glm::vec3(0.0f);
+        glm::vec3 meanVelocity = glm::vec3(0.0f);
+        glm::vec3 velocityDispersion = glm::vec3(0.0f);  // Per-axis standard deviation
+        glm::vec3 angularMomentum = glm::vec3(0.0f);     // About the centre of mass, unit masses
+        float kineticEnergy = 0.0f;
+        float radialProfile[HISTOGRAM_BINS] = {};        // Points per shell out to histogramRadius
+    };
+
+    GalaxyStatistics(WGPUDevice device, PipelineManager& pipelines, BufferAllocator& allocator,
+                     ReadbackManager& readback, uint32_t pointCount, float timeStep);
+    ~GalaxyStatistics();
+
+    // Binds the simulation's ping-pong buffers
+    void setParticleBuffers(WGPUBuffer bufferA, WGPUBuffer bufferB, uint64_t size);
+
+    // Records the reduction after the simulation step that wrote B from A (aToB) or A from B
+    void dispatch(WGPUComputePassEncoder computePass, bool aToB);
+
+    bool enabled = true;
+    float histogramRadius = 40.0f;
+
+    bool hasSummary() const { return summaryCount > 0; }
+    const Summary& getSummary() const { return summary; }
+    size_t getSummaryCount() const { return summaryCount; }
+
+    // Ring buffers for ImGui::PlotLines; the oldest sample is at getHistoryOffset()
+    const float* getEnergyHistory() const { return energyHistory.data(); }
+    const float* getAngularMomentumHistory() const { return angularMomentumHistory.data(); }
+    int getHistoryOffset() const { return historyOffset; }
+
+private:
+    // Mirrors Partial in galaxy_stats.wgsl
+    struct Partial {
+        float sumPosition[4];
+        float minPosition[4];
+        float maxPosition[4];
+        float sumVelocity[4];
+        float sumVelocitySq[4];
+        float angularMomentum[4];
+        uint32_t histogram[HISTOGRAM_BINS];
+    };
+
+    struct Params {
+        float histogramRadius;
+        float timeStep;
+        uint32_t pointCount;
+        uint32_t partialCount;
+    };
+
+    void createBindGroupLayout();
+    void createPipelines();
+    void onResult(const Partial& result);
+
+    static constexpr uint32_t WORKGROUP_SIZE = 128;
+    static constexpr uint32_t MAX_PARTIALS = 256;
+
+    WGPUDevice device;
+    PipelineManager& pipelines;
+    BufferAllocator& allocator;
+    ReadbackManager& readback;
+    uint32_t pointCount;
+    uint32_t partialCount;
+    float timeStep;
+
+    PipelineManager::Handle partialsPipeline = PipelineManager::INVALID_HANDLE;
+    PipelineManager::Handle finalPipeline = PipelineManager::INVALID_HANDLE;
+    GpuBindGroupLayout bindGroupLayout;
+    GpuBindGroup bindGroupAToB;
+    GpuBindGroup bindGroupBToA;
+    GpuBuffer partialsBuffer;
+    GpuBuffer resultBuffer;
+    BufferAllocation paramsBuffer;
+    float uploadedRadius = 0.0f;
+
+    bool readbackPending = false;
+    Summary summary;
+    size_t summaryCount = 0;
+    std::vector<float> energyHistory;
+    std::vector<float> angularMomentumHistory;
+    int historyOffset = 0;
+};
@@ -0,0 +1,68 @@
+#include "GpuAsync.h"
+#include <stdio.h>
+
+GpuCallback<WGPUAdapter> requestAdapter(AsyncPump& pump, WGPUInstance instance, const WGPURequestAdapterOptions* options) {
+    return {pump, [instance, options](GpuCallback<WGPUAdapter>* self) {
+        auto onAdapter = [](WGPURequestAdapterStatus status, WGPUAdapter adapter, const char* message, void* userdata) {
+            if (status != WGPURequestAdapterStatus_Success) {
+                printf("Could not get WebGPU adapter: %s\n", message ? message : "");
+                adapter = nullptr;
+            }
+            static_cast<GpuCallback<WGPUAdapter>*>(userdata)->complete(adapter);
+        };
+        wgpuInstanceRequestAdapter(instance, options, onAdapter, self);
+    }};
+}
+
+GpuCallback<WGPUDevice> requestDevice(AsyncPump& pump, WGPUAdapter adapter, const WGPUDeviceDescriptor* descriptor) {
+    return {pump, [adapter, descriptor](GpuCallback<WGPUDevice>* self) {
+        auto onDevice = [](WGPURequestDeviceStatus status, WGPUDevice device, const char* message, void* userdata) {
+            if (status != WGPURequestDeviceStatus_Success) {
+                printf("Could not get WebGPU device: %s\n", message ? message : "");
+                device = nullptr;
+            }
+            static_cast<GpuCallback<WGPUDevice>*>(userdata)->complete(device);
+        };
+        wgpuAdapterRequestDevice(adapter, descriptor, onDevice, self);
+    }};
+}
+
+GpuCallback<WGPUBufferMapAsyncStatus> mapAsync(AsyncPump& pump, WGPUBuffer buffer, WGPUMapModeFlags mode,
+                                               size_t offset, size_t size) {
+    return {pump, [buffer, mode, offset, size](GpuCallback<WGPUBufferMapAsyncStatus>* self) {
+        auto onMapped = [](WGPUBufferMapAsyncStatus status, void* userdata) {
+            static_cast<GpuCallback<WGPUBufferMapAsyncStatus>*>(userdata)->complete(status);
+        };
+        wgpuBufferMapAsync(buffer, mode, offset, size, onMapped, self);
+    }};
+}
+
+GpuCallback<WGPURenderPipeline> createRenderPipelineAsync(AsyncPump& pump, WGPUDevice device,
+                                                          const WGPURenderPipelineDescriptor* descriptor) {
+    return {pump, [device, descriptor](GpuCallback<WGPURenderPipeline>* self) {
+        auto onCreated = [](WGPUCreatePipelineAsyncStatus status, WGPURenderPipeline pipeline, const char* message,
+                            void* userdata) {
+            if (status != WGPUCreatePipelineAsyncStatus_Success) {
+                printf("Failed to create render pipeline: %s\n", message ? message : "");
+                pipeline = nullptr;
+            }
+            static_cast<GpuCallback<WGPURenderPipeline>*>(userdata)->complete(pipeline);
+        };
+        wgpuDeviceCreateRenderPipelineAsync(device, descriptor, onCreated, self);
+    }};
+}
+
+GpuCallback<WGPUComputePipeline> createComputePipelineAsync(AsyncPump& pump, WGPUDevice device,
+                                                            const WGPUComputePipelineDescriptor* descriptor) {
+    return {pump, [device, descriptor](GpuCallback<WGPUComputePipeline>* self) {
+        auto onCreated = [](WGPUCreatePipelineAsyncStatus status, WGPUComputePipeline pipeline, const char* message,
+                            void* userdata) {
+            if (status != WGPUCreatePipelineAsyncStatus_Success) {
+                printf("Failed to create compute pipeline: %s\n", message ? message : "");
+                pipeline = nullptr;
+            }
+            static_cast<GpuCallback<WGPUComputePipeline>*>(userdata)->complete(pipeline);
+        };
+        wgpuDeviceCreateComputePipelineAsync(device, descriptor, onCreated, self);
+    }};
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <webgpu/webgpu.h>
+#include <atomic>
+#include <functional>
+#include "AsyncPump.h"
+
+// Awaitable for one callback-based WebGPU call, e.g. `WGPUAdapter adapter = co_await
+// requestAdapter(pump, instance, nullptr);`. The call is issued when the coroutine suspends,
+// so descriptors only need to live for the co_await expression. The coroutine is resumed by
+// the pump's next run(), or right away if the callback fired during the call itself.
+template <typename Result>
+class GpuCallback {
+public:
+    using Start = std::function<void(GpuCallback* self)>;
+
+    GpuCallback(AsyncPump& pump, Start start) : pump(pump), start(std::move(start)) {}
+
+    GpuCallback(const GpuCallback&) = delete;
+    GpuCallback& operator=(const GpuCallback&) = delete;
+
+    bool await_ready() const noexcept { return false; }
+    bool await_suspend(std::coroutine_handle<> awaiting) {
+        handle = awaiting;
+        start(this);
+        return state.exchange(SUSPENDED) != COMPLETED;
+    }
+    Result await_resume() { return std::move(result); }
+
+    // Called from the WebGPU callback, on whichever thread delivers it
+    void complete(Result value) {
+        result = std::move(value);
+        if (state.exchange(COMPLETED) == SUSPENDED) pump.schedule(handle);
+    }
+
+private:
+    enum State { PENDING, SUSPENDED, COMPLETED };
+
+    AsyncPump& pump;
+    Start start;
+    std::coroutine_handle<> handle;
+    std::atomic<int> state{PENDING};
+    Result result{};
+};
+
+// Failures print the WebGPU message and resume with nullptr (or the failed map status)
+GpuCallback<WGPUAdapter> requestAdapter(AsyncPump& pump, WGPUInstance instance, const WGPURequestAdapterOptions* options);
+GpuCallback<WGPUDevice> requestDevice(AsyncPump& pump, WGPUAdapter adapter, const WGPUDeviceDescriptor* descriptor);
+GpuCallback<WGPUBufferMapAsyncStatus> mapAsync(AsyncPump& pump, WGPUBuffer buffer, WGPUMapModeFlags mode,
+                                               size_t offset, size_t size);
+GpuCallback<WGPURenderPipeline> createRenderPipelineAsync(AsyncPump& pump, WGPUDevice device,
+                                                          const WGPURenderPipelineDescriptor* descriptor);
+GpuCallback<WGPUComputePipeline> createComputePipelineAsync(AsyncPump& pump, WGPUDevice device,
+                                                            const WGPUComputePipelineDescriptor* descriptor);
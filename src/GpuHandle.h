@@ -0,0 +1,64 @@
+#pragma once
+
+#include <webgpu/webgpu.h>
+#include <utility>
+
+// Release function for each WebGPU handle type wrapped by GpuHandle
+template <typename T> struct GpuHandleTraits;
+
+#define GPU_HANDLE_TRAITS(Type, Release) \
+    template <> struct GpuHandleTraits<Type> { static void release(Type handle) { Release(handle); } };
+
+GPU_HANDLE_TRAITS(WGPUBuffer, wgpuBufferRelease)
+GPU_HANDLE_TRAITS(WGPUTexture, wgpuTextureRelease)
+GPU_HANDLE_TRAITS(WGPUTextureView, wgpuTextureViewRelease)
+GPU_HANDLE_TRAITS(WGPUSampler, wgpuSamplerRelease)
+GPU_HANDLE_TRAITS(WGPUBindGroup, wgpuBindGroupRelease)
+GPU_HANDLE_TRAITS(WGPUBindGroupLayout, wgpuBindGroupLayoutRelease)
+GPU_HANDLE_TRAITS(WGPURenderBundle, wgpuRenderBundleRelease)
+GPU_HANDLE_TRAITS(WGPUQuerySet, wgpuQuerySetRelease)
+
+#undef GPU_HANDLE_TRAITS
+
+// Move-only owner of a single WebGPU handle, released on destruction or reset().
+// Resources replaced while frames may still be using them should be handed to
+// ReleaseQueue::retire() instead of being reset directly.
+template <typename T>
+class GpuHandle {
+public:
+    GpuHandle() = default;
+    explicit GpuHandle(T handle) : handle(handle) {}
+    ~GpuHandle() { reset(); }
+
+    GpuHandle(const GpuHandle&) = delete;
+    GpuHandle& operator=(const GpuHandle&) = delete;
+
+    GpuHandle(GpuHandle&& other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+    GpuHandle& operator=(GpuHandle&& other) noexcept {
+        if (this != &other) reset(std::exchange(other.handle, nullptr));
+        return *this;
+    }
+
+    T get() const { return handle; }
+    explicit operator bool() const { return handle != nullptr; }
+
+    // Gives up ownership without releasing
+    T release() { return std::exchange(handle, nullptr); }
+
+    void reset(T newHandle = nullptr) {
+        if (handle) GpuHandleTraits<T>::release(handle);
+        handle = newHandle;
+    }
+
+private:
+    T handle = nullptr;
+};
+
+using GpuBuffer = GpuHandle<WGPUBuffer>;
+using GpuTexture = GpuHandle<WGPUTexture>;
+using GpuTextureView = GpuHandle<WGPUTextureView>;
+using GpuSampler = GpuHandle<WGPUSampler>;
+using GpuBindGroup = GpuHandle<WGPUBindGroup>;
+using GpuBindGroupLayout = GpuHandle<WGPUBindGroupLayout>;
+using GpuRenderBundle = GpuHandle<WGPURenderBundle>;
+using GpuQuerySet = GpuHandle<WGPUQuerySet>;
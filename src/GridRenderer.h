@@ -2,49 +2,46 @@
 #include <webgpu/webgpu.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
-#include <vector>
 #include "Camera.h"
-
+#include "PipelineManager.h"
+#include "RenderBundleCache.h"
+#include "BundleRecorder.h"
+#include "GpuHandle.h"
+#include "BufferAllocator.h"
+
+// Infinite ground grid drawn as a single fullscreen pass. Lines are computed analytically in
+// the fragment shader, so there is no geometry and the cost is the same at any zoom level.
 class GridRenderer {
 public:
-    GridRenderer(WGPUDevice device);
+    GridRenderer(WGPUDevice device, PipelineManager& pipelines, BufferAllocator& allocator);
     ~GridRenderer();
 
-    void render(WGPURenderPassEncoder renderPass, const Camera& camera);
+    // Updates uniforms and returns the cache holding the draw, queueing a re-record on the recorder
+    // when it is stale; nullptr while the pipeline compiles
+    RenderBundleCache* getRenderBundle(const Camera& camera, BundleRecorder& recorder);
     void cleanup();
 
 private:
     void createPipeline();
-    void createVertexBuffer();
     void createUniformBuffer();
     void createBindGroup();
     void updateUniformBuffer(const Camera& camera);
 
-    // Grid configuration
-    static constexpr float GRID_SIZE = 20.0f;  // Total size of the grid
-    static constexpr float GRID_SPACING = 1.0f; // Space between grid lines
-    static constexpr float MAJOR_LINE_INTERVAL = 5.0f; // Interval for major (darker) lines
-
-    // Structure for vertices
-    struct Vertex {
-        float position[3];  // x, y, z coordinates
-        float color[4];     // rgba color with alpha for different line weights
-    };
-
     // Structure for uniform buffer
     struct UniformData {
-        glm::mat4 viewProj;
+        glm::mat4 inverseViewProj;
+        glm::vec4 cameraPosition;
     };
 
-    std::vector<Vertex> generateGridVertices();
-
     WGPUDevice device;
-    WGPURenderPipeline pipeline = nullptr;
-    WGPUBuffer vertexBuffer = nullptr;
-    WGPUBuffer uniformBuffer = nullptr;
-    WGPUBindGroup bindGroup = nullptr;
-    WGPUBindGroupLayout bindGroupLayout = nullptr;
+    PipelineManager& pipelines;
+    BufferAllocator& allocator;
+    PipelineManager::Handle pipeline = PipelineManager::INVALID_HANDLE;
+    BufferAllocation uniformBuffer;
+    GpuBindGroup bindGroup;
+    GpuBindGroupLayout bindGroupLayout;
+    RenderBundleCache bundle;
 
-    std::vector<Vertex> vertices;
     UniformData uniformData;
-};
\ No newline at end of file
+    uint64_t cameraVersion = UINT64_MAX;  // Camera version last uploaded
+};
@@ -0,0 +1,252 @@
+#include "JobSystem.h"
+#include <algorithm>
+
+struct Job {
+    std::function<void()> work;
+    JobCounter* signal = nullptr;  // Decremented once work returns
+};
+
+// Deque slot of the current thread in the job system it belongs to; -1 for outside threads
+static thread_local const JobSystem* currentSystem = nullptr;
+static thread_local int currentSlot = -1;
+
+// MARK: WorkStealingDeque
+
+bool WorkStealingDeque::push(Job* job) {
+    int64_t b = bottom.load(std::memory_order_relaxed);
+    int64_t t = top.load(std::memory_order_acquire);
+    if (b - t >= CAPACITY) return false;
+
+    buffer[b & (CAPACITY - 1)].store(job, std::memory_order_relaxed);
+    bottom.store(b + 1, std::memory_order_release);
+    return true;
+}
+
+Job* WorkStealingDeque::pop() {
+    int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+    bottom.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t t = top.load(std::memory_order_relaxed);
+
+    if (t > b) {
+        bottom.store(b + 1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    Job* job = buffer[b & (CAPACITY - 1)].load(std::memory_order_relaxed);
+    if (t == b) {
+        // Last job: race the thieves for it
+        if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            job = nullptr;
+        }
+        bottom.store(b + 1, std::memory_order_relaxed);
+    }
+    return job;
+}
+
+Job* WorkStealingDeque::steal() {
+    int64_t t = top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t b = bottom.load(std::memory_order_acquire);
+    if (t >= b) return nullptr;
+
+    Job* job = buffer[t & (CAPACITY - 1)].load(std::memory_order_relaxed);
+    if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+        return nullptr;
+    }
+    return job;
+}
+
+// MARK: JobSystem
+
+JobSystem::JobSystem(int workerCount) : mainThread(std::this_thread::get_id()) {
+#if JOB_SYSTEM_THREADS
+    if (workerCount < 0) workerCount = std::max(1u, std::thread::hardware_concurrency()) - 1;
+#else
+    workerCount = 0;
+#endif
+    currentSystem = this;
+    currentSlot = 0;
+
+    for (int i = 0; i <= workerCount; i++) {
+        deques.push_back(std::make_unique<WorkStealingDeque>());
+    }
+    for (int i = 1; i <= workerCount; i++) {
+        workers.emplace_back(&JobSystem::workerMain, this, i);
+    }
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    wakeUp.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    workers.clear();
+
+    // Whatever is left was never waited for; run it so counters and continuations settle.
+    // With the workers gone, anything scheduled from here on runs inline.
+    while (Job* job = findJob()) execute(job);
+    pumpMainThread();
+    if (currentSystem == this) currentSystem = nullptr;
+}
+
+Job* JobSystem::createJob(std::function<void()> work, JobCounter* signal) {
+    if (signal) signal->pending.fetch_add(1, std::memory_order_relaxed);
+    return new Job{std::move(work), signal};
+}
+
+void JobSystem::run(std::function<void()> work, JobCounter* signal) {
+    schedule(createJob(std::move(work), signal));
+}
+
+void JobSystem::runAfter(JobCounter& dependency, std::function<void()> work, JobCounter* signal) {
+    Job* job = createJob(std::move(work), signal);
+    {
+        std::lock_guard<std::mutex> lock(dependency.mutex);
+        if (!dependency.isDone()) {
+            dependency.continuations.push_back(job);
+            return;
+        }
+    }
+    schedule(job);
+}
+
+void JobSystem::runOnMainThread(std::function<void()> work, JobCounter* signal) {
+    Job* job = createJob(std::move(work), signal);
+    std::lock_guard<std::mutex> lock(mainThreadMutex);
+    mainThreadJobs.push_back(job);
+}
+
+void JobSystem::schedule(Job* job) {
+    if (workers.empty()) {
+        execute(job);
+        return;
+    }
+
+    // Counted before it becomes visible, so a thief never takes the count below zero
+    queuedCount.fetch_add(1, std::memory_order_seq_cst);
+    if (currentSystem != this || currentSlot < 0 || !deques[currentSlot]->push(job)) {
+        std::lock_guard<std::mutex> lock(injectedMutex);
+        injected.push_back(job);
+    }
+
+    if (sleepingCount.load(std::memory_order_seq_cst) > 0) {
+        // Taking the lock orders this with a worker between checking queuedCount and sleeping
+        { std::lock_guard<std::mutex> lock(sleepMutex); }
+        wakeUp.notify_one();
+    }
+}
+
+void JobSystem::execute(Job* job) {
+    job->work();
+    if (job->signal) finish(*job->signal);
+    delete job;
+    executedCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+void JobSystem::finish(JobCounter& counter) {
+    // The lock also keeps a waiter that saw the counter reach zero from destroying it under us
+    std::vector<Job*> ready;
+    {
+        std::lock_guard<std::mutex> lock(counter.mutex);
+        if (counter.pending.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+        ready.swap(counter.continuations);
+    }
+    for (Job* job : ready) {
+        schedule(job);
+    }
+}
+
+Job* JobSystem::findJob() {
+    int slot = currentSystem == this ? currentSlot : -1;
+    Job* job = slot >= 0 ? deques[slot]->pop() : nullptr;
+
+    if (!job) {
+        // Start at a different victim on every thread so thieves spread out
+        static thread_local uint32_t seed = (uint32_t)std::hash<std::thread::id>()(std::this_thread::get_id()) | 1;
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        size_t count = deques.size();
+        for (size_t i = 0; i < count && !job; i++) {
+            size_t victim = (seed + i) % count;
+            if ((int)victim == slot) continue;
+            job = deques[victim]->steal();
+        }
+        if (job) stealCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    if (!job) {
+        std::lock_guard<std::mutex> lock(injectedMutex);
+        if (!injected.empty()) {
+            job = injected.back();
+            injected.pop_back();
+        }
+    }
+
+    if (job) queuedCount.fetch_sub(1, std::memory_order_relaxed);
+    return job;
+}
+
+void JobSystem::workerMain(int index) {
+    currentSystem = this;
+    currentSlot = index;
+
+    while (true) {
+        if (Job* job = findJob()) {
+            execute(job);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        sleepingCount.fetch_add(1, std::memory_order_seq_cst);
+        wakeUp.wait(lock, [this] { return stopping || queuedCount.load(std::memory_order_seq_cst) > 0; });
+        sleepingCount.fetch_sub(1, std::memory_order_relaxed);
+        if (stopping) return;
+    }
+}
+
+// MARK: Waiting
+
+void JobSystem::wait(JobCounter& counter) {
+    bool onMainThread = isMainThread();
+    while (!counter.isDone()) {
+        if (onMainThread) pumpMainThread();
+        if (Job* job = findJob()) {
+            execute(job);
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    // Wait out the job that took the counter to zero before the caller may destroy it
+    std::lock_guard<std::mutex> lock(counter.mutex);
+}
+
+void JobSystem::pumpMainThread() {
+    std::vector<Job*> jobs;
+    {
+        std::lock_guard<std::mutex> lock(mainThreadMutex);
+        jobs.swap(mainThreadJobs);
+    }
+    for (Job* job : jobs) {
+        execute(job);
+    }
+}
+
+void JobSystem::parallelFor(size_t begin, size_t end, size_t grainSize,
+                            const std::function<void(size_t, size_t)>& body) {
+    if (begin >= end) return;
+    grainSize = std::max<size_t>(grainSize, 1);
+
+    // The calling thread takes the first chunk itself rather than queueing it
+    JobCounter counter;
+    for (size_t chunk = begin + grainSize; chunk < end; chunk += grainSize) {
+        size_t chunkEnd = std::min(chunk + grainSize, end);
+        run([&body, chunk, chunkEnd] { body(chunk, chunkEnd); }, &counter);
+    }
+    body(begin, std::min(begin + grainSize, end));
+    wait(counter);
+}
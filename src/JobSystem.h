@@ -0,0 +1,134 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Web builds only get threads when compiled with -pthread (USE_PTHREADS=1 in Makefile.emscripten)
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+#define JOB_SYSTEM_THREADS 0
+#else
+#define JOB_SYSTEM_THREADS 1
+#endif
+
+struct Job;
+
+// Tracks a group of jobs. Every job run with the counter as its signal holds it above zero
+// until it finishes; JobSystem::wait() and JobSystem::runAfter() key off it reaching zero.
+// A counter may be reused once it is done, but must outlive the jobs signalling it.
+class JobCounter {
+public:
+    JobCounter() = default;
+    JobCounter(const JobCounter&) = delete;
+    JobCounter& operator=(const JobCounter&) = delete;
+
+    bool isDone() const { return pending.load(std::memory_order_acquire) == 0; }
+
+private:
+    friend class JobSystem;
+
+    std::atomic<int> pending{0};
+    std::mutex mutex;                // Held while the last job finishes and while continuations are added
+    std::vector<Job*> continuations;  // Jobs started by runAfter() once pending reaches zero
+};
+
+// Fixed-capacity Chase-Lev deque (Le et al., "Correct and Efficient Work-Stealing for Weak
+// Memory Models"). The owning thread pushes and pops at the bottom, other threads steal from
+// the top, and only the last remaining job is contended.
+class WorkStealingDeque {
+public:
+    static constexpr int64_t CAPACITY = 4096;  // Power of two
+
+    // Owner only; false when full
+    bool push(Job* job);
+    // Owner only; most recently pushed job or nullptr
+    Job* pop();
+    // Any thread; oldest job or nullptr when empty or lost to another thief
+    Job* steal();
+
+private:
+    alignas(64) std::atomic<int64_t> top{0};
+    alignas(64) std::atomic<int64_t> bottom{0};
+    std::atomic<Job*> buffer[CAPACITY] = {};
+};
+
+// Work-stealing job system for engine tasks: particle generation, asset decoding, CPU
+// simulation. Each worker owns a deque and steals from the others when it runs dry; the thread
+// that created the system is the main thread and owns a deque too, which it works through
+// whenever it waits.
+//
+// Jobs may run on any thread, so they must not call WebGPU unless the device synchronizes calls
+// itself (Dawn's ImplicitDeviceSynchronization, which BundleRecorder's parallel recording
+// relies on); other WebGPU work, and anything else bound to the main thread, goes through
+// runOnMainThread(). Without threads, jobs run inline.
+class JobSystem {
+public:
+    // -1 starts one worker per hardware thread beyond the calling one
+    explicit JobSystem(int workerCount = -1);
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    // Queues work on any thread
+    void run(std::function<void()> work, JobCounter* signal = nullptr);
+
+    // Queues work to start once dependency reaches zero (immediately if it already has)
+    void runAfter(JobCounter& dependency, std::function<void()> work, JobCounter* signal = nullptr);
+
+    // Queues work for the main thread, picked up by pumpMainThread() or by wait() there
+    void runOnMainThread(std::function<void()> work, JobCounter* signal = nullptr);
+
+    // Runs body(chunkBegin, chunkEnd) over [begin, end) in chunks of at most grainSize items,
+    // with the calling thread joining in, and returns when all chunks are done
+    void parallelFor(size_t begin, size_t end, size_t grainSize, const std::function<void(size_t, size_t)>& body);
+
+    // Runs other jobs until counter reaches zero
+    void wait(JobCounter& counter);
+
+    // Runs the queued main-thread jobs; call once per frame on the main thread
+    void pumpMainThread();
+
+    bool isMainThread() const { return std::this_thread::get_id() == mainThread; }
+    int getWorkerCount() const { return (int)workers.size(); }
+
+    // Totals since startup, for profiling
+    size_t getExecutedCount() const { return executedCount.load(std::memory_order_relaxed); }
+    size_t getStealCount() const { return stealCount.load(std::memory_order_relaxed); }
+
+private:
+    Job* createJob(std::function<void()> work, JobCounter* signal);
+    void schedule(Job* job);
+    void execute(Job* job);
+    void finish(JobCounter& counter);
+    Job* findJob();
+    void workerMain(int index);
+
+    std::thread::id mainThread;
+    std::vector<std::thread> workers;
+    // Slot 0 belongs to the main thread, slot i to worker i
+    std::vector<std::unique_ptr<WorkStealingDeque>> deques;
+
+    // Jobs from threads without a deque (the render thread) or that found theirs full
+    std::mutex injectedMutex;
+    std::vector<Job*> injected;
+
+    std::mutex mainThreadMutex;
+    std::vector<Job*> mainThreadJobs;
+
+    // Idle workers sleep until queuedCount is non-zero
+    std::atomic<int> queuedCount{0};
+    std::atomic<int> sleepingCount{0};
+    std::mutex sleepMutex;
+    std::condition_variable wakeUp;
+    bool stopping = false;
+
+    std::atomic<size_t> executedCount{0};
+    std::atomic<size_t> stealCount{0};
+};
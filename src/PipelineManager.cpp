@@ -0,0 +1,382 @@
+#include "PipelineManager.h"
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+// FNV-1a, good enough to key a handful of pipeline descriptors
+constexpr uint64_t FNV_OFFSET = 0xcbf29ce484222325ULL;
+constexpr uint64_t FNV_PRIME = 0x100000001b3ULL;
+
+void hashBytes(uint64_t& hash, const void* data, size_t size) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= FNV_PRIME;
+    }
+}
+
+template <typename T>
+void hashValue(uint64_t& hash, const T& value) {
+    hashBytes(hash, &value, sizeof(T));
+}
+
+void hashString(uint64_t& hash, const std::string& str) {
+    hashValue(hash, str.size());
+    hashBytes(hash, str.data(), str.size());
+}
+
+double msSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+PipelineManager::PipelineManager(WGPUDevice device, ShaderLibrary& shaders, AsyncPump& pump)
+    : device(device), shaders(shaders), pump(pump) {
+    lastShaderPoll = std::chrono::steady_clock::now();
+}
+
+PipelineManager::~PipelineManager() {
+    for (Request* request : outstanding) {
+        request->manager = nullptr;
+    }
+    for (Entry& entry : entries) {
+        if (entry.renderPipeline) wgpuRenderPipelineRelease(entry.renderPipeline);
+        if (entry.computePipeline) wgpuComputePipelineRelease(entry.computePipeline);
+        if (entry.stagedRenderPipeline) wgpuRenderPipelineRelease(entry.stagedRenderPipeline);
+        if (entry.stagedComputePipeline) wgpuComputePipelineRelease(entry.stagedComputePipeline);
+    }
+}
+
+// MARK: Frame boundary
+void PipelineManager::beginFrame() {
+    for (Entry& entry : entries) {
+        if (entry.stagedRenderPipeline) {
+            if (entry.renderPipeline) wgpuRenderPipelineRelease(entry.renderPipeline);
+            entry.renderPipeline = entry.stagedRenderPipeline;
+            entry.stagedRenderPipeline = nullptr;
+            entry.version++;
+        }
+        if (entry.stagedComputePipeline) {
+            if (entry.computePipeline) wgpuComputePipelineRelease(entry.computePipeline);
+            entry.computePipeline = entry.stagedComputePipeline;
+            entry.stagedComputePipeline = nullptr;
+            entry.version++;
+        }
+    }
+
+    if (!shaders.isWatching() || msSince(lastShaderPoll) < SHADER_POLL_INTERVAL_MS) return;
+    lastShaderPoll = std::chrono::steady_clock::now();
+    for (const std::string& name : shaders.pollChanges()) {
+        reloadShader(name);
+    }
+}
+
+void PipelineManager::reloadShader(const std::string& name) {
+    for (Handle handle = 0; handle < entries.size(); handle++) {
+        if (entries[handle].shaderName() == name) {
+            compile(handle);
+        }
+    }
+}
+
+// MARK: Hashing
+uint64_t PipelineManager::hashDesc(const RenderPipelineDesc& desc) {
+    uint64_t hash = FNV_OFFSET;
+    hashValue(hash, Kind::Render);
+    hashString(hash, desc.shaderName);
+    hashString(hash, desc.vertexEntryPoint);
+    hashString(hash, desc.fragmentEntryPoint);
+    for (WGPUBindGroupLayout layout : desc.bindGroupLayouts) {
+        hashValue(hash, layout);
+    }
+    for (const VertexBufferDesc& buffer : desc.vertexBuffers) {
+        hashValue(hash, buffer.arrayStride);
+        hashValue(hash, buffer.stepMode);
+        for (const WGPUVertexAttribute& attribute : buffer.attributes) {
+            hashValue(hash, attribute.format);
+            hashValue(hash, attribute.offset);
+            hashValue(hash, attribute.shaderLocation);
+        }
+    }
+    hashValue(hash, desc.topology);
+    hashValue(hash, desc.colorFormat);
+    hashValue(hash, desc.blend);
+    return hash;
+}
+
+uint64_t PipelineManager::hashDesc(const ComputePipelineDesc& desc) {
+    uint64_t hash = FNV_OFFSET;
+    hashValue(hash, Kind::Compute);
+    hashString(hash, desc.shaderName);
+    hashString(hash, desc.entryPoint);
+    for (WGPUBindGroupLayout layout : desc.bindGroupLayouts) {
+        hashValue(hash, layout);
+    }
+    return hash;
+}
+
+bool PipelineManager::sameDesc(const RenderPipelineDesc& a, const RenderPipelineDesc& b) {
+    if (a.shaderName != b.shaderName || a.vertexEntryPoint != b.vertexEntryPoint ||
+        a.fragmentEntryPoint != b.fragmentEntryPoint || a.bindGroupLayouts != b.bindGroupLayouts ||
+        a.vertexBuffers.size() != b.vertexBuffers.size() || a.topology != b.topology ||
+        a.colorFormat != b.colorFormat || memcmp(&a.blend, &b.blend, sizeof(WGPUBlendState)) != 0) {
+        return false;
+    }
+    for (size_t i = 0; i < a.vertexBuffers.size(); i++) {
+        const VertexBufferDesc& bufferA = a.vertexBuffers[i];
+        const VertexBufferDesc& bufferB = b.vertexBuffers[i];
+        if (bufferA.arrayStride != bufferB.arrayStride || bufferA.stepMode != bufferB.stepMode ||
+            bufferA.attributes.size() != bufferB.attributes.size()) {
+            return false;
+        }
+        for (size_t j = 0; j < bufferA.attributes.size(); j++) {
+            const WGPUVertexAttribute& attributeA = bufferA.attributes[j];
+            const WGPUVertexAttribute& attributeB = bufferB.attributes[j];
+            if (attributeA.format != attributeB.format || attributeA.offset != attributeB.offset ||
+                attributeA.shaderLocation != attributeB.shaderLocation) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool PipelineManager::sameDesc(const ComputePipelineDesc& a, const ComputePipelineDesc& b) {
+    return a.shaderName == b.shaderName && a.entryPoint == b.entryPoint && a.bindGroupLayouts == b.bindGroupLayouts;
+}
+
+PipelineManager::Handle PipelineManager::findEntry(uint64_t hash, Kind kind, const RenderPipelineDesc* renderDesc,
+                                                   const ComputePipelineDesc* computeDesc) const {
+    auto [begin, end] = handlesByHash.equal_range(hash);
+    for (auto it = begin; it != end; ++it) {
+        const Entry& entry = entries[it->second];
+        if (entry.kind != kind) continue;
+        if (kind == Kind::Render ? sameDesc(entry.renderDesc, *renderDesc) : sameDesc(entry.computeDesc, *computeDesc)) {
+            return it->second;
+        }
+    }
+    return INVALID_HANDLE;
+}
+
+// MARK: Requests
+PipelineManager::Handle PipelineManager::requestRenderPipeline(const RenderPipelineDesc& desc) {
+    uint64_t hash = hashDesc(desc);
+    Handle existing = findEntry(hash, Kind::Render, &desc, nullptr);
+    if (existing != INVALID_HANDLE) {
+        dedupHits++;
+        return existing;
+    }
+
+    Handle handle = static_cast<Handle>(entries.size());
+    Entry entry = {};
+    entry.kind = Kind::Render;
+    entry.renderDesc = desc;
+    entries.push_back(std::move(entry));
+    handlesByHash.emplace(hash, handle);
+
+    compile(handle);
+    return handle;
+}
+
+PipelineManager::Handle PipelineManager::requestComputePipeline(const ComputePipelineDesc& desc) {
+    uint64_t hash = hashDesc(desc);
+    Handle existing = findEntry(hash, Kind::Compute, nullptr, &desc);
+    if (existing != INVALID_HANDLE) {
+        dedupHits++;
+        return existing;
+    }
+
+    Handle handle = static_cast<Handle>(entries.size());
+    Entry entry = {};
+    entry.kind = Kind::Compute;
+    entry.computeDesc = desc;
+    entries.push_back(std::move(entry));
+    handlesByHash.emplace(hash, handle);
+
+    compile(handle);
+    return handle;
+}
+
+WGPURenderPipeline PipelineManager::getRenderPipeline(Handle handle) const {
+    if (handle >= entries.size()) return nullptr;
+    return entries[handle].renderPipeline;
+}
+
+WGPUComputePipeline PipelineManager::getComputePipeline(Handle handle) const {
+    if (handle >= entries.size()) return nullptr;
+    return entries[handle].computePipeline;
+}
+
+uint32_t PipelineManager::getVersion(Handle handle) const {
+    if (handle >= entries.size()) return 0;
+    return entries[handle].version;
+}
+
+// MARK: Compilation
+void PipelineManager::compile(Handle handle) {
+    if (entries[handle].kind == Kind::Render) {
+        compileRenderPipeline(handle);
+    } else {
+        compileComputePipeline(handle);
+    }
+}
+
+WGPUShaderModule PipelineManager::createShaderModule(const std::string& source, const std::string& label) {
+    WGPUShaderModuleWGSLDescriptor wgslDesc = {};
+    wgslDesc.chain.sType = WGPUSType_ShaderModuleWGSLDescriptor;
+    wgslDesc.code = source.c_str();
+
+    WGPUShaderModuleDescriptor shaderDesc = {};
+    shaderDesc.nextInChain = reinterpret_cast<WGPUChainedStruct*>(&wgslDesc);
+    shaderDesc.label = label.c_str();
+    return wgpuDeviceCreateShaderModule(device, &shaderDesc);
+}
+
+WGPUPipelineLayout PipelineManager::createPipelineLayout(const std::vector<WGPUBindGroupLayout>& layouts) {
+    WGPUPipelineLayoutDescriptor layoutDesc = {};
+    layoutDesc.bindGroupLayoutCount = layouts.size();
+    layoutDesc.bindGroupLayouts = layouts.data();
+    return wgpuDeviceCreatePipelineLayout(device, &layoutDesc);
+}
+
+PipelineManager::Request* PipelineManager::newRequest(Handle handle) {
+    if (!hasFirstRequest) {
+        hasFirstRequest = true;
+        firstRequestTime = std::chrono::steady_clock::now();
+    }
+
+    // A newer compile supersedes any request still in flight for this handle
+    Entry& entry = entries[handle];
+    entry.generation++;
+    entry.requestTime = std::chrono::steady_clock::now();
+    pendingCount++;
+
+    Request* request = new Request{this, handle, entry.generation};
+    outstanding.insert(request);
+    return request;
+}
+
+void PipelineManager::compileRenderPipeline(Handle handle) {
+    const RenderPipelineDesc& desc = entries[handle].renderDesc;
+
+    WGPUShaderModule shaderModule = createShaderModule(shaders.getSource(desc.shaderName), desc.label);
+    WGPUPipelineLayout pipelineLayout = createPipelineLayout(desc.bindGroupLayouts);
+
+    std::vector<WGPUVertexBufferLayout> bufferLayouts(desc.vertexBuffers.size());
+    for (size_t i = 0; i < desc.vertexBuffers.size(); i++) {
+        bufferLayouts[i].arrayStride = desc.vertexBuffers[i].arrayStride;
+        bufferLayouts[i].stepMode = desc.vertexBuffers[i].stepMode;
+        bufferLayouts[i].attributeCount = desc.vertexBuffers[i].attributes.size();
+        bufferLayouts[i].attributes = desc.vertexBuffers[i].attributes.data();
+    }
+
+    WGPUColorTargetState colorTarget = {};
+    colorTarget.format = desc.colorFormat;
+    colorTarget.blend = &desc.blend;
+    colorTarget.writeMask = WGPUColorWriteMask_All;
+
+    WGPUFragmentState fragment = {};
+    fragment.module = shaderModule;
+    fragment.entryPoint = desc.fragmentEntryPoint.c_str();
+    fragment.targetCount = 1;
+    fragment.targets = &colorTarget;
+
+    WGPURenderPipelineDescriptor pipelineDesc = {};
+    pipelineDesc.label = desc.label.c_str();
+    pipelineDesc.layout = pipelineLayout;
+    pipelineDesc.vertex.module = shaderModule;
+    pipelineDesc.vertex.entryPoint = desc.vertexEntryPoint.c_str();
+    pipelineDesc.vertex.bufferCount = bufferLayouts.size();
+    pipelineDesc.vertex.buffers = bufferLayouts.data();
+    pipelineDesc.fragment = &fragment;
+    pipelineDesc.primitive.topology = desc.topology;
+    pipelineDesc.primitive.stripIndexFormat = WGPUIndexFormat_Undefined;
+    pipelineDesc.primitive.frontFace = WGPUFrontFace_CCW;
+    pipelineDesc.primitive.cullMode = WGPUCullMode_None;
+    pipelineDesc.multisample.count = 1;
+    pipelineDesc.multisample.mask = 0xFFFFFFFF;
+    pipelineDesc.multisample.alphaToCoverageEnabled = false;
+
+    pump.spawn(awaitRenderPipeline(pump, device, &pipelineDesc, newRequest(handle)));
+
+    // The pending pipeline holds its own references
+    wgpuShaderModuleRelease(shaderModule);
+    wgpuPipelineLayoutRelease(pipelineLayout);
+}
+
+void PipelineManager::compileComputePipeline(Handle handle) {
+    const ComputePipelineDesc& desc = entries[handle].computeDesc;
+
+    WGPUShaderModule shaderModule = createShaderModule(shaders.getSource(desc.shaderName), desc.label);
+    WGPUPipelineLayout pipelineLayout = createPipelineLayout(desc.bindGroupLayouts);
+
+    WGPUComputePipelineDescriptor pipelineDesc = {};
+    pipelineDesc.label = desc.label.c_str();
+    pipelineDesc.layout = pipelineLayout;
+    pipelineDesc.compute.module = shaderModule;
+    pipelineDesc.compute.entryPoint = desc.entryPoint.c_str();
+
+    pump.spawn(awaitComputePipeline(pump, device, &pipelineDesc, newRequest(handle)));
+
+    wgpuShaderModuleRelease(shaderModule);
+    wgpuPipelineLayoutRelease(pipelineLayout);
+}
+
+// MARK: Completion
+bool PipelineManager::finishRequest(Request* request, bool succeeded) {
+    outstanding.erase(request);
+    pendingCount--;
+
+    Entry& entry = entries[request->handle];
+    if (request->generation != entry.generation) {
+        return false;
+    }
+
+    if (succeeded) {
+        entry.failed = false;
+        printf("Pipeline '%s' ready after %.1f ms\n", entry.label().c_str(), msSince(entry.requestTime));
+    } else {
+        // The WebGPU message has been printed by the awaitable
+        entry.failed = true;
+        printf("Failed to create pipeline '%s'%s\n", entry.label().c_str(),
+               entry.renderPipeline || entry.computePipeline ? ", keeping previous version" : "");
+    }
+
+    if (pendingCount == 0 && allReadyMs == 0.0) {
+        allReadyMs = msSince(firstRequestTime);
+        printf("All %zu pipelines ready %.1f ms after first request\n", entries.size(), allReadyMs);
+    }
+    return succeeded;
+}
+
+Task<void> PipelineManager::awaitRenderPipeline(AsyncPump& pump, WGPUDevice device,
+                                                const WGPURenderPipelineDescriptor* descriptor, Request* request) {
+    WGPURenderPipeline pipeline = co_await createRenderPipelineAsync(pump, device, descriptor);
+    PipelineManager* manager = request->manager;
+
+    if (manager && manager->finishRequest(request, pipeline != nullptr)) {
+        Entry& entry = manager->entries[request->handle];
+        if (entry.stagedRenderPipeline) wgpuRenderPipelineRelease(entry.stagedRenderPipeline);
+        entry.stagedRenderPipeline = pipeline;
+    } else if (pipeline) {
+        wgpuRenderPipelineRelease(pipeline);
+    }
+    delete request;
+}
+
+Task<void> PipelineManager::awaitComputePipeline(AsyncPump& pump, WGPUDevice device,
+                                                 const WGPUComputePipelineDescriptor* descriptor, Request* request) {
+    WGPUComputePipeline pipeline = co_await createComputePipelineAsync(pump, device, descriptor);
+    PipelineManager* manager = request->manager;
+
+    if (manager && manager->finishRequest(request, pipeline != nullptr)) {
+        Entry& entry = manager->entries[request->handle];
+        if (entry.stagedComputePipeline) wgpuComputePipelineRelease(entry.stagedComputePipeline);
+        entry.stagedComputePipeline = pipeline;
+    } else if (pipeline) {
+        wgpuComputePipelineRelease(pipeline);
+    }
+    delete request;
+}
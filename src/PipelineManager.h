@@ -0,0 +1,152 @@
+#pragma once
+
+#include <webgpu/webgpu.h>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "ShaderLibrary.h"
+#include "GpuAsync.h"
+
+// Color format every scene pipeline and render bundle is built for
+constexpr WGPUTextureFormat SCENE_COLOR_FORMAT = WGPUTextureFormat_BGRA8Unorm;
+
+// Vertex buffer layout that owns its attribute array, so descriptors can be stored and hashed
+struct VertexBufferDesc {
+    uint64_t arrayStride = 0;
+    WGPUVertexStepMode stepMode = WGPUVertexStepMode_Vertex;
+    std::vector<WGPUVertexAttribute> attributes;
+};
+
+struct RenderPipelineDesc {
+    std::string label;
+    std::string shaderName;
+    std::string vertexEntryPoint = "vs_main";
+    std::string fragmentEntryPoint = "fs_main";
+    std::vector<WGPUBindGroupLayout> bindGroupLayouts;
+    std::vector<VertexBufferDesc> vertexBuffers;
+    WGPUPrimitiveTopology topology = WGPUPrimitiveTopology_TriangleList;
+    WGPUTextureFormat colorFormat = SCENE_COLOR_FORMAT;
+    WGPUBlendState blend = {
+        {WGPUBlendOperation_Add, WGPUBlendFactor_One, WGPUBlendFactor_Zero},
+        {WGPUBlendOperation_Add, WGPUBlendFactor_One, WGPUBlendFactor_Zero}
+    };
+};
+
+struct ComputePipelineDesc {
+    std::string label;
+    std::string shaderName;
+    std::string entryPoint = "main";
+    std::vector<WGPUBindGroupLayout> bindGroupLayouts;
+};
+
+// Creates pipelines off the startup critical path: each compile is a coroutine awaiting
+// wgpuDeviceCreate*PipelineAsync, resumed by the async pump once the pipeline is ready.
+// Identical descriptors (everything but the label) are deduplicated and share one pipeline. Until a pipeline
+// has finished compiling its getter returns nullptr and callers are expected to skip drawing.
+//
+// Compiled pipelines are staged and only become visible in beginFrame(), so a pipeline never
+// changes in the middle of a frame. When a watched shader changes on disk every pipeline using
+// it is recompiled in the background; if that fails the previous pipeline stays in use.
+class PipelineManager {
+public:
+    using Handle = uint32_t;
+    static constexpr Handle INVALID_HANDLE = UINT32_MAX;
+
+    PipelineManager(WGPUDevice device, ShaderLibrary& shaders, AsyncPump& pump);
+    ~PipelineManager();
+
+    // Swaps in pipelines that finished compiling and polls watched shader files
+    void beginFrame();
+
+    Handle requestRenderPipeline(const RenderPipelineDesc& desc);
+    Handle requestComputePipeline(const ComputePipelineDesc& desc);
+
+    WGPURenderPipeline getRenderPipeline(Handle handle) const;
+    WGPUComputePipeline getComputePipeline(Handle handle) const;
+
+    // Bumped every time a new pipeline is swapped in for this handle
+    uint32_t getVersion(Handle handle) const;
+
+    size_t getPipelineCount() const { return entries.size(); }
+    size_t getPendingCount() const { return pendingCount; }
+    size_t getDedupHits() const { return dedupHits; }
+
+    // Time from the first request until every pipeline requested so far had compiled
+    double getAllReadyMs() const { return allReadyMs; }
+
+private:
+    enum class Kind { Render, Compute };
+
+    struct Entry {
+        Kind kind;
+        RenderPipelineDesc renderDesc;
+        ComputePipelineDesc computeDesc;
+        WGPURenderPipeline renderPipeline = nullptr;
+        WGPUComputePipeline computePipeline = nullptr;
+        WGPURenderPipeline stagedRenderPipeline = nullptr;
+        WGPUComputePipeline stagedComputePipeline = nullptr;
+        uint32_t generation = 0;
+        uint32_t version = 0;
+        bool failed = false;
+        std::chrono::steady_clock::time_point requestTime;
+
+        const std::string& shaderName() const {
+            return kind == Kind::Render ? renderDesc.shaderName : computeDesc.shaderName;
+        }
+        const std::string& label() const {
+            return kind == Kind::Render ? renderDesc.label : computeDesc.label;
+        }
+    };
+
+    // Heap-allocated state shared with a compile coroutine. The manager detaches outstanding
+    // requests on destruction so late completions only release the pipeline they receive.
+    struct Request {
+        PipelineManager* manager;
+        Handle handle;
+        uint32_t generation;
+    };
+
+    static uint64_t hashDesc(const RenderPipelineDesc& desc);
+    static uint64_t hashDesc(const ComputePipelineDesc& desc);
+    // Compare exactly the fields the hashes cover, so a hash collision never shares a pipeline
+    static bool sameDesc(const RenderPipelineDesc& a, const RenderPipelineDesc& b);
+    static bool sameDesc(const ComputePipelineDesc& a, const ComputePipelineDesc& b);
+    Handle findEntry(uint64_t hash, Kind kind, const RenderPipelineDesc* renderDesc,
+                     const ComputePipelineDesc* computeDesc) const;
+
+    void compile(Handle handle);
+    void compileRenderPipeline(Handle handle);
+    void compileComputePipeline(Handle handle);
+    void reloadShader(const std::string& name);
+    WGPUShaderModule createShaderModule(const std::string& source, const std::string& label);
+    WGPUPipelineLayout createPipelineLayout(const std::vector<WGPUBindGroupLayout>& layouts);
+    Request* newRequest(Handle handle);
+    // Returns false if the request is stale or orphaned and its result must be discarded
+    bool finishRequest(Request* request, bool succeeded);
+
+    // The pipeline is requested before the first suspension, so descriptor only has to outlive
+    // the spawn() that starts the coroutine
+    static Task<void> awaitRenderPipeline(AsyncPump& pump, WGPUDevice device,
+                                          const WGPURenderPipelineDescriptor* descriptor, Request* request);
+    static Task<void> awaitComputePipeline(AsyncPump& pump, WGPUDevice device,
+                                           const WGPUComputePipelineDescriptor* descriptor, Request* request);
+
+    static constexpr double SHADER_POLL_INTERVAL_MS = 500.0;
+
+    WGPUDevice device;
+    ShaderLibrary& shaders;
+    AsyncPump& pump;
+    std::vector<Entry> entries;
+    std::unordered_multimap<uint64_t, Handle> handlesByHash;  // Render and compute share the map
+    std::unordered_set<Request*> outstanding;
+
+    size_t pendingCount = 0;
+    size_t dedupHits = 0;
+    bool hasFirstRequest = false;
+    std::chrono::steady_clock::time_point firstRequestTime;
+    double allReadyMs = 0.0;
+    std::chrono::steady_clock::time_point lastShaderPoll;
+};
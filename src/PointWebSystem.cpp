@@ -1,221 +1,168 @@
 #include "PointWebSystem.h"
 #include <cstring>
 #include <iostream>
-
-PointWebSystem::PointWebSystem(WGPUDevice device) : device(device) {
+#include <algorithm>
+#include <cmath>
+#include <glm/gtc/matrix_transform.hpp>
+
+#ifdef USE_GALAXY_ASSET
+// Baked by tools/bake_galaxy.cpp; relative to the page on the web and to the working directory on desktop
+#ifdef __EMSCRIPTEN__
+static constexpr const char* GALAXY_ASSET_PATH = "galaxy.gxic";
+#else
+static constexpr const char* GALAXY_ASSET_PATH = "web/galaxy.gxic";
+#endif
+#endif
+
+PointWebSystem::PointWebSystem(WGPUDevice device, PipelineManager& pipelines, ReleaseQueue& releaseQueue,
+                               BufferAllocator& allocator, UploadManager& uploads, ReadbackManager& readback,
+                               JobSystem& jobs)
+    : device(device), pipelines(pipelines), releaseQueue(releaseQueue), allocator(allocator), uploads(uploads),
+      readback(readback), jobs(jobs) {
     initPoints();
     createBuffers();
+#ifdef USE_GALAXY_ASSET
+    loadAsset(GALAXY_ASSET_PATH);
+#else
+    uploadGeneratedPoints();
+#endif
     createPipelineAndResources();
     createComputePipeline();
     createBindGroups();
+    setInstances({GalaxyInstance{}});
+
+    statistics = std::make_unique<GalaxyStatistics>(device, pipelines, allocator, readback, POINT_CAPACITY,
+                                                    SIMULATION_STEP);
+    statistics->setParticleBuffers(vertexBufferA.get(), vertexBufferB.get(), sizeof(Point) * POINT_CAPACITY);
 }
 
 PointWebSystem::~PointWebSystem() {
-    if (vertexBufferA) wgpuBufferRelease(vertexBufferA);
-    if (vertexBufferB) wgpuBufferRelease(vertexBufferB);
-    if (uniformBuffer) wgpuBufferRelease(uniformBuffer);
-    if (renderPipeline) wgpuRenderPipelineRelease(renderPipeline);
-    if (computePipeline) wgpuComputePipelineRelease(computePipeline);
-    if (renderBindGroup) wgpuBindGroupRelease(renderBindGroup);
-    if (computeBindGroupA) wgpuBindGroupRelease(computeBindGroupA);
-    if (computeBindGroupB) wgpuBindGroupRelease(computeBindGroupB);
-    if (renderBindGroupLayout) wgpuBindGroupLayoutRelease(renderBindGroupLayout);
-    if (computeBindGroupLayout) wgpuBindGroupLayoutRelease(computeBindGroupLayout);
-    if (ellipseBuffer) wgpuBufferRelease(ellipseBuffer);
+    uploads.cancel(vertexBufferA.get());
+    uploads.cancel(vertexBufferB.get());
+    readback.cancel(vertexBufferA.get());
+    readback.cancel(vertexBufferB.get());
+    allocator.free(uniformBuffer);
+    allocator.free(ellipseBuffer);
 }
 
 // MARK: initPoints
+// Only the ellipse parameters live on the CPU; the points are generated chunk by chunk into
+// the upload staging buffers (generatePoints) and never exist as a whole in host memory
 void PointWebSystem::initPoints() {
-    points.resize(NUM_POINTS);
-    
-    int starsPerEllipse = NUM_POINTS / MAX_ELLIPSES;
-    float currentEllipseSize = 1.83f; // Base radius from galaxy system
-    float tiltIncrement = 0.16f;      // From galaxy system
-    
-    for (int ellipseIndex = 0; ellipseIndex < MAX_ELLIPSES; ellipseIndex++) {
-        int startIndex = ellipseIndex * starsPerEllipse;
-        int endIndex = (ellipseIndex == MAX_ELLIPSES - 1) ? NUM_POINTS : startIndex + starsPerEllipse;
-        int starsInThisEllipse = endIndex - startIndex;
-
-        float angleStep = (2.0f * 3.14159f) / starsInThisEllipse;
-        float currentTilt = ellipseIndex * tiltIncrement;
-
-        for (int i = startIndex; i < endIndex; i++) {
-            float t = (i - startIndex) * angleStep;
-            
-            // Base position calculation
-            float x = currentEllipseSize * cos(t) * cos(currentTilt);
-            float z = currentEllipseSize * cos(t) * sin(currentTilt);
-            
-            // Calculate height using rough approximation of de Vaucouleurs's Law
-            float radius = sqrt(x * x + z * z) + 0.0001f;
-            float baseHeight = 0.5f * exp(-1.4f * pow(radius/3.66f, 0.25f));
-            float randomizedHeight = baseHeight * (hash(i) * 2.0f - 1.0f);
-
-            // Random offset for more natural distribution
-            float randRadius = hash(i * 12.345f) * currentEllipseSize;
-            float randAngle = hash(i * 67.890f) * 2.0f * 3.14159f;
-            
-            // Calculate offsets
-            float offsetX = randRadius * cos(randAngle);
-            float offsetZ = randRadius * sin(randAngle);
-
-            // Set final position
-            points[i].position[0] = x + offsetX;
-            points[i].position[1] = randomizedHeight;
-            points[i].position[2] = z + offsetZ;
-
-            // Store parameters in velocity for compute shader
-            points[i].velocity[0] = t;                // angle
-            points[i].velocity[1] = randomizedHeight; // stored height
-            points[i].velocity[2] = randRadius;       // radial offset
+    GalaxyGenerator::initEllipses(ellipseParams, ellipsePopulations);
+}
+
+void PointWebSystem::generatePoints(uint32_t first, uint32_t count, Point* out) {
+    // Every slot is a pure function of its index and its ellipse, so chunks split across jobs
+    jobs.parallelFor(0, count, GENERATE_GRAIN, [&](size_t begin, size_t end) {
+        for (size_t n = begin; n < end; n++) {
+            out[n] = GalaxyGenerator::generatePoint(int(first + n), ellipseParams.data(), ellipsePopulations.data());
         }
+    });
+}
 
-        currentEllipseSize += 0.5f; // Increment size for next ellipse
-    }
+void PointWebSystem::uploadGeneratedPoints() {
+    // Both buffers start from the same points, generated into the staging buffers over the
+    // next frames and copied to each; nothing is simulated or drawn until they have landed
+    pendingParticleUploads = 1;
+    uploads.uploadGenerated({vertexBufferA.get(), vertexBufferB.get()}, 0, sizeof(Point), POINT_CAPACITY,
+        [this](uint64_t first, uint64_t count, void* out) { generatePoints(first, count, static_cast<Point*>(out)); },
+        [this] {
+            pendingParticleUploads--;
+            asset.reset();  // Left over from a failed load
+        });
 }
 
-// Helper function for hash (used in initialization)
-float PointWebSystem::hash(uint32_t n) {
-    n = (n << 13U) ^ n;
-    n = n * (n * n * 15731U + 0x789221U) + 0x137631U;
-    return float(n & 0x7fffffffU) / float(0x7fffffff);
+// MARK: loadAsset
+// Each chunk is queued for upload as soon as it is available and decoded straight into staging
+// memory when encoded, so the upload follows the download instead of waiting for it
+void PointWebSystem::loadAsset(const char* path) {
+    pendingParticleUploads = 1;  // Until the header says how many chunks follow
+
+    GalaxyAsset::Callbacks callbacks;
+    callbacks.onHeader = [this](const GalaxyAsset& loaded) {
+        const GalaxyAssetHeader& header = loaded.getHeader();
+        if (header.pointCount != POINT_CAPACITY || header.ellipseCount != MAX_ELLIPSES ||
+            header.ellipseCapacity != ELLIPSE_CAPACITY) {
+            printf("Galaxy asset was baked for a different slot layout (%u points, %u x %u ellipse slots)\n",
+                   header.pointCount, header.ellipseCount, header.ellipseCapacity);
+            return false;
+        }
+        ellipseParams.assign(loaded.getEllipses(), loaded.getEllipses() + MAX_ELLIPSES);
+        ellipsePopulations.assign(loaded.getPopulations(), loaded.getPopulations() + MAX_ELLIPSES);
+        allocator.write(ellipseBuffer, ellipseParams.data(), sizeof(EllipseParams) * MAX_ELLIPSES);
+        pendingParticleUploads = header.chunkCount;
+        return true;
+    };
+    callbacks.onChunk = [this](uint32_t chunkIndex) {
+        uint64_t firstSlot = uint64_t(chunkIndex) * asset->getHeader().chunkPoints;
+        uploads.uploadGenerated({vertexBufferA.get(), vertexBufferB.get()}, firstSlot * sizeof(Point), sizeof(Point),
+            asset->getChunk(chunkIndex).pointCount, [this, chunkIndex, firstSlot](uint64_t first, uint64_t count, void* out) {
+                if (!asset->decode(chunkIndex, uint32_t(first), uint32_t(count), static_cast<Point*>(out))) {
+                    // The asset's ellipses still describe the galaxy, so regenerate what was lost
+                    printf("Galaxy asset chunk %u is corrupt, generating it\n", chunkIndex);
+                    generatePoints(uint32_t(firstSlot + first), uint32_t(count), static_cast<Point*>(out));
+                }
+            },
+            [this] {
+                if (--pendingParticleUploads == 0) asset.reset();
+            });
+    };
+    callbacks.onFailed = [this](const char*) {
+        // Start over from the default preset, dropping whatever chunks were already queued.
+        // The asset is released once the generated points have uploaded, not inside its own callback.
+        uploads.cancel(vertexBufferA.get());
+        uploads.cancel(vertexBufferB.get());
+        initPoints();
+        allocator.write(ellipseBuffer, ellipseParams.data(), sizeof(EllipseParams) * MAX_ELLIPSES);
+        uploadGeneratedPoints();
+    };
+
+    asset = std::make_unique<GalaxyAsset>(std::move(callbacks));
+    asset->load(path);
 }
 
 void PointWebSystem::createPipelineAndResources() {
     // Create render bind group layout first
-    WGPUBindGroupLayoutEntry bglEntry = {};
-    bglEntry.binding = 0;
-    bglEntry.visibility = WGPUShaderStage_Vertex;
-    bglEntry.buffer.type = WGPUBufferBindingType_Uniform;
-    bglEntry.buffer.hasDynamicOffset = false;
-    bglEntry.buffer.minBindingSize = sizeof(UniformData);
+    WGPUBindGroupLayoutEntry bglEntries[2] = {};
+    // Camera uniforms
+    bglEntries[0].binding = 0;
+    bglEntries[0].visibility = WGPUShaderStage_Vertex;
+    bglEntries[0].buffer.type = WGPUBufferBindingType_Uniform;
+    bglEntries[0].buffer.hasDynamicOffset = false;
+    bglEntries[0].buffer.minBindingSize = sizeof(UniformData);
+    // Galaxy instances
+    bglEntries[1].binding = 1;
+    bglEntries[1].visibility = WGPUShaderStage_Vertex;
+    bglEntries[1].buffer.type = WGPUBufferBindingType_ReadOnlyStorage;
+    bglEntries[1].buffer.minBindingSize = sizeof(GalaxyInstance);
 
     WGPUBindGroupLayoutDescriptor bglDesc = {};
-    bglDesc.entryCount = 1;
-    bglDesc.entries = &bglEntry;
+    bglDesc.entryCount = 2;
+    bglDesc.entries = bglEntries;
     
-    renderBindGroupLayout = wgpuDeviceCreateBindGroupLayout(device, &bglDesc);
-    printf("Created render bind group layout: %p\n", (void*)renderBindGroupLayout);
-
-    // Create bind group
-    if (uniformBuffer && renderBindGroupLayout) {
-        WGPUBindGroupEntry bgEntry = {};
-        bgEntry.binding = 0;
-        bgEntry.buffer = uniformBuffer;
-        bgEntry.offset = 0;
-        bgEntry.size = sizeof(UniformData);
-
-        WGPUBindGroupDescriptor bgDesc = {};
-        bgDesc.layout = renderBindGroupLayout;
-        bgDesc.entryCount = 1;
-        bgDesc.entries = &bgEntry;
-
-        printf("Before creating bind group. Layout: %p, Buffer: %p\n", 
-               (void*)renderBindGroupLayout, (void*)uniformBuffer);
-        renderBindGroup = wgpuDeviceCreateBindGroup(device, &bgDesc);
-        printf("After creating bind group: %p\n", (void*)renderBindGroup);
-    } else {
-        printf("Failed preconditions for bind group. Layout: %p, Buffer: %p\n",
-               (void*)renderBindGroupLayout, (void*)uniformBuffer);
-    }
+    renderBindGroupLayout.reset(wgpuDeviceCreateBindGroupLayout(device, &bglDesc));
 
-    // Create shader module
-    WGPUShaderModuleWGSLDescriptor wgslDesc = {};
-    wgslDesc.chain.sType = WGPUSType_ShaderModuleWGSLDescriptor;
-    wgslDesc.code = R"(
-            struct Uniforms {
-                viewProj: mat4x4<f32>,
-            }
-            @binding(0) @group(0) var<uniform> uniforms: Uniforms;
-
-            struct VertexInput {
-                @location(0) position: vec3f,
-            };
-
-            struct VertexOutput {
-                @builtin(position) position: vec4f,
-            };
-
-            @vertex
-            fn vs_main(in: VertexInput) -> VertexOutput {
-                var out: VertexOutput;
-                let worldPos = vec4f(in.position, 1.0);
-                out.position = uniforms.viewProj * worldPos;
-                return out;
-            }
-
-            @fragment
-            fn fs_main() -> @location(0) vec4f {
-                // Fixed white color for testing
-                return vec4f(1.0, 1.0, 1.0, 1.0);
-            }
-        )";
-
-    WGPUShaderModuleDescriptor shaderDesc = {};
-    shaderDesc.nextInChain = reinterpret_cast<WGPUChainedStruct*>(&wgslDesc);
-    WGPUShaderModule shaderModule = wgpuDeviceCreateShaderModule(device, &shaderDesc);
-
-    // Create pipeline layout
-    WGPUPipelineLayoutDescriptor layoutDesc = {};
-    layoutDesc.bindGroupLayoutCount = 1;
-    layoutDesc.bindGroupLayouts = &renderBindGroupLayout;
-    WGPUPipelineLayout pipelineLayout = wgpuDeviceCreatePipelineLayout(device, &layoutDesc);
+    RenderPipelineDesc pipelineDesc;
+    pipelineDesc.label = "Galaxy points";
+    pipelineDesc.shaderName = "galaxy_points";
+    pipelineDesc.bindGroupLayouts = {renderBindGroupLayout.get()};
 
     // Set up vertex attributes and buffer layout
-    WGPUVertexAttribute attribute = {};
-    attribute.format = WGPUVertexFormat_Float32x3;
-    attribute.offset = offsetof(Point, position);
-    attribute.shaderLocation = 0;
-
-    WGPUVertexBufferLayout vertexBufferLayout = {};
-    vertexBufferLayout.arrayStride = sizeof(Point);
-    vertexBufferLayout.stepMode = WGPUVertexStepMode_Vertex;
-    vertexBufferLayout.attributeCount = 1;
-    vertexBufferLayout.attributes = &attribute;
-
-    // Fragment state
-    WGPUBlendState blend = {};
-    blend.color.operation = WGPUBlendOperation_Add;
-    blend.color.srcFactor = WGPUBlendFactor_SrcAlpha;
-    blend.color.dstFactor = WGPUBlendFactor_OneMinusSrcAlpha;
-    blend.alpha = blend.color;
-
-    WGPUColorTargetState colorTarget = {};
-    colorTarget.format = WGPUTextureFormat_BGRA8Unorm;
-    colorTarget.blend = &blend;
-    colorTarget.writeMask = WGPUColorWriteMask_All;
-
-    WGPUFragmentState fragment = {};
-    fragment.module = shaderModule;
-    fragment.entryPoint = "fs_main";
-    fragment.targetCount = 1;
-    fragment.targets = &colorTarget;
-
-    // Create render pipeline
-    WGPURenderPipelineDescriptor pipelineDesc = {};
-    pipelineDesc.vertex.module = shaderModule;
-    pipelineDesc.vertex.entryPoint = "vs_main";
-    pipelineDesc.vertex.bufferCount = 1;
-    pipelineDesc.vertex.buffers = &vertexBufferLayout;
-    pipelineDesc.primitive.topology = WGPUPrimitiveTopology_PointList;
-    pipelineDesc.primitive.stripIndexFormat = WGPUIndexFormat_Undefined;
-    pipelineDesc.primitive.frontFace = WGPUFrontFace_CCW;
-    pipelineDesc.primitive.cullMode = WGPUCullMode_None;
-    pipelineDesc.fragment = &fragment;
-    pipelineDesc.layout = pipelineLayout;
-
-    WGPUMultisampleState multisample = {};
-    multisample.count = 1;
-    multisample.mask = 0xFFFFFFFF;
-    multisample.alphaToCoverageEnabled = false;
-    pipelineDesc.multisample = multisample;
-
-    renderPipeline = wgpuDeviceCreateRenderPipeline(device, &pipelineDesc);
-
-    // Cleanup
-    wgpuShaderModuleRelease(shaderModule);
-    wgpuPipelineLayoutRelease(pipelineLayout);
+    VertexBufferDesc vertexBuffer;
+    vertexBuffer.arrayStride = sizeof(Point);
+    vertexBuffer.stepMode = WGPUVertexStepMode_Vertex;
+    vertexBuffer.attributes = {{WGPUVertexFormat_Float32x3, offsetof(Point, position), 0},
+                               {WGPUVertexFormat_Uint32, offsetof(Point, ellipse), 1}};
+    pipelineDesc.vertexBuffers = {vertexBuffer};
+    pipelineDesc.topology = WGPUPrimitiveTopology_PointList;
+
+    pipelineDesc.blend.color.operation = WGPUBlendOperation_Add;
+    pipelineDesc.blend.color.srcFactor = WGPUBlendFactor_SrcAlpha;
+    pipelineDesc.blend.color.dstFactor = WGPUBlendFactor_OneMinusSrcAlpha;
+    pipelineDesc.blend.alpha = pipelineDesc.blend.color;
+
+    renderPipeline = pipelines.requestRenderPipeline(pipelineDesc);
 }
 
 
@@ -238,258 +185,120 @@ void PointWebSystem::createComputePipeline() {
     WGPUBindGroupLayoutDescriptor bindGroupLayoutDesc = {};
     bindGroupLayoutDesc.entryCount = 3;
     bindGroupLayoutDesc.entries = layoutEntries;
-    computeBindGroupLayout = wgpuDeviceCreateBindGroupLayout(device, &bindGroupLayoutDesc);
+    computeBindGroupLayout.reset(wgpuDeviceCreateBindGroupLayout(device, &bindGroupLayoutDesc));
 
     if (!computeBindGroupLayout) {
         printf("Failed to create compute bind group layout!\n");
         return;
     }
 
-    // Now create the pipeline layout using the bind group layout
-    WGPUPipelineLayoutDescriptor pipelineLayoutDesc = {};
-    pipelineLayoutDesc.bindGroupLayoutCount = 1;
-    pipelineLayoutDesc.bindGroupLayouts = &computeBindGroupLayout;
-    WGPUPipelineLayout pipelineLayout = wgpuDeviceCreatePipelineLayout(device, &pipelineLayoutDesc);
-
-    if (!pipelineLayout) {
-        printf("Failed to create compute pipeline layout!\n");
-        return;
-    }
-
-    // Create compute shader
-    WGPUShaderModuleWGSLDescriptor computeWGSLDesc = {};
-    computeWGSLDesc.chain.sType = WGPUSType_ShaderModuleWGSLDescriptor;
-    computeWGSLDesc.code = R"(
-        struct Point {
-            @align(16) position: vec3f,
-            @align(16) velocity: vec3f,
-        }
-
-        struct EllipseParams {
-            majorAxis: f32,
-            minorAxis: f32,
-            tiltAngle: f32,
-        }
-
-        @group(0) @binding(0) var<storage, read> input: array<Point>;
-        @group(0) @binding(1) var<storage, read_write> output: array<Point>;
-        @group(0) @binding(2) var<storage, read> ellipses: array<EllipseParams>;
-
-        const BASE_ROTATION_SPEED: f32 = -0.01;
-        const SPEED_MULTIPLIER: f32 = 20.0;
-
-        fn hash(n: u32) -> f32 {
-            var nn = n;
-            nn = (nn << 13u) ^ nn;
-            nn = nn * (nn * nn * 15731u + 0x789221u) + 0x137631u;
-            return f32(nn & 0x7fffffffu) / f32(0x7fffffff);
-        }
+    // Create compute pipeline
+    ComputePipelineDesc pipelineDesc;
+    pipelineDesc.label = "Galaxy orbit update";
+    pipelineDesc.shaderName = "galaxy_update";
+    pipelineDesc.entryPoint = "main";
+    pipelineDesc.bindGroupLayouts = {computeBindGroupLayout.get()};
 
-        @compute @workgroup_size(256)
-        fn main(@builtin(global_invocation_id) global_id : vec3u) {
-            let index = global_id.x;
-            if (index >= arrayLength(&input)) {
-                return;
-            }
-
-            let starsPerEllipse = arrayLength(&input) / arrayLength(&ellipses);
-            let ellipseIndex = min(index / starsPerEllipse, arrayLength(&ellipses) - 1);
-            let params = ellipses[ellipseIndex];
-
-            // Get stored parameters
-            let currentAngle = input[index].velocity.x;
-            let storedHeight = input[index].velocity.y;
-            let radialOffset = input[index].velocity.z;
-
-            // Calculate rotation speed based on ellipse size
-            let speedFactor = SPEED_MULTIPLIER / max(params.majorAxis, 0.1);
-            let rotationSpeed = BASE_ROTATION_SPEED * speedFactor;
-
-            // Update angle
-            var newAngle = currentAngle + rotationSpeed * 0.016;
-            if (newAngle > 6.28318) {
-                newAngle = newAngle - 6.28318;
-            }
-
-            // Calculate base ellipse position
-            let x = params.majorAxis * cos(newAngle) * cos(params.tiltAngle) -
-                    params.minorAxis * sin(newAngle) * sin(params.tiltAngle);
-            let z = params.majorAxis * cos(newAngle) * sin(params.tiltAngle) +
-                    params.minorAxis * sin(newAngle) * cos(params.tiltAngle);
-
-            // Apply stored radial offset in orbital plane
-            let offsetAngle = newAngle + radialOffset;
-            let offset = vec3f(
-                cos(offsetAngle) * radialOffset,
-                0.0,
-                sin(offsetAngle) * radialOffset
-            );
-
-            // Combine position with stored height
-            let newPosition = vec3f(x, storedHeight, z) + offset;
-
-            // Update the point
-            output[index].position = newPosition;
-            output[index].velocity = vec3f(newAngle, storedHeight, radialOffset);
-        }
-    )";
-
-    WGPUShaderModuleDescriptor shaderDesc = {};
-    shaderDesc.nextInChain = reinterpret_cast<WGPUChainedStruct*>(&computeWGSLDesc);
-    WGPUShaderModule shaderModule = wgpuDeviceCreateShaderModule(device, &shaderDesc);
-
-    if (!shaderModule) {
-        printf("Failed to create compute shader module!\n");
-        wgpuPipelineLayoutRelease(pipelineLayout);
-        return;
-    }
-
-    // Create the compute pipeline
-    WGPUComputePipelineDescriptor pipelineDesc = {};
-    pipelineDesc.layout = pipelineLayout;
-    pipelineDesc.compute.module = shaderModule;
-    pipelineDesc.compute.entryPoint = "main";
-
-    computePipeline = wgpuDeviceCreateComputePipeline(device, &pipelineDesc);
-
-    // Cleanup
-    wgpuShaderModuleRelease(shaderModule);
-    wgpuPipelineLayoutRelease(pipelineLayout);
+    computePipeline = pipelines.requestComputePipeline(pipelineDesc);
 }
 
 
 void PointWebSystem::compute(WGPUComputePassEncoder computePass) {
-    wgpuComputePassEncoderSetPipeline(computePass, computePipeline);
+    // Still compiling or still uploading: leave the points where they are
+    WGPUComputePipeline pipeline = pipelines.getComputePipeline(computePipeline);
+    if (!pipeline || pendingParticleUploads > 0) return;
+
+    wgpuComputePassEncoderSetPipeline(computePass, pipeline);
     wgpuComputePassEncoderSetBindGroup(computePass, 0, 
-        useBufferA ? computeBindGroupA : computeBindGroupB, 0, nullptr);
+        useBufferA ? computeBindGroupA.get() : computeBindGroupB.get(), 0, nullptr);
         
     // Calculate workgroup count to cover all points
-    uint32_t workgroupCount = (NUM_POINTS + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE;
+    uint32_t workgroupCount = (POINT_CAPACITY + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE;
     wgpuComputePassEncoderDispatchWorkgroups(computePass, workgroupCount, 1, 1);
+
+    statistics->dispatch(computePass, useBufferA);
 }
 
 
 void PointWebSystem::createBuffers() {
     // Create vertex buffers for double buffering
     WGPUBufferDescriptor vertexBufferDesc = {};
-    vertexBufferDesc.size = sizeof(Point) * points.size();
+    vertexBufferDesc.size = sizeof(Point) * POINT_CAPACITY;
     // Update usage flags to include read-only storage
-    vertexBufferDesc.usage = WGPUBufferUsage_Vertex | WGPUBufferUsage_Storage | WGPUBufferUsage_CopyDst;
-    vertexBufferDesc.mappedAtCreation = true;
-
-    // Create and initialize buffer A
-    vertexBufferA = wgpuDeviceCreateBuffer(device, &vertexBufferDesc);
-    void* vertexDataA = wgpuBufferGetMappedRange(vertexBufferA, 0, vertexBufferDesc.size);
-    memcpy(vertexDataA, points.data(), vertexBufferDesc.size);
-    wgpuBufferUnmap(vertexBufferA);
-
-    // Create buffer B (initially empty)
-    vertexBufferB = wgpuDeviceCreateBuffer(device, &vertexBufferDesc);
-    void* vertexDataB = wgpuBufferGetMappedRange(vertexBufferB, 0, vertexBufferDesc.size);
-    memcpy(vertexDataB, points.data(), vertexBufferDesc.size);
-    wgpuBufferUnmap(vertexBufferB);
-
-    // Create uniform buffer
-    WGPUBufferDescriptor uniformDesc = {};
-    uniformDesc.size = sizeof(UniformData);
-    uniformDesc.usage = WGPUBufferUsage_Uniform | WGPUBufferUsage_CopyDst;
-    uniformDesc.mappedAtCreation = false;
-    uniformBuffer = wgpuDeviceCreateBuffer(device, &uniformDesc);
-
-    // Create ellipse parameters buffer
-    WGPUBufferDescriptor ellipseBufferDesc = {};
-    ellipseBufferDesc.size = sizeof(EllipseParams) * MAX_ELLIPSES;
-    ellipseBufferDesc.usage = WGPUBufferUsage_Storage | WGPUBufferUsage_CopyDst;
-    ellipseBufferDesc.mappedAtCreation = true;
-    
-    ellipseBuffer = wgpuDeviceCreateBuffer(device, &ellipseBufferDesc);
-    
-    // Initialize ellipse parameters
-    ellipseParams.resize(MAX_ELLIPSES);
-    float currentRadius = 1.83f; // Base radius
-    float tiltIncrement = 0.16f;
-    
-    for (int i = 0; i < MAX_ELLIPSES; i++) {
-        ellipseParams[i].majorAxis = currentRadius;
-        ellipseParams[i].minorAxis = currentRadius * 0.8f; // eccentricity of 0.8
-        ellipseParams[i].tiltAngle = i * tiltIncrement;
-        currentRadius += 0.5f;
-    }
-    
-    // Copy ellipse parameters to buffer
-    void* ellipseData = wgpuBufferGetMappedRange(ellipseBuffer, 0, ellipseBufferDesc.size);
-    memcpy(ellipseData, ellipseParams.data(), ellipseBufferDesc.size);
-    wgpuBufferUnmap(ellipseBuffer);
+    vertexBufferDesc.usage = WGPUBufferUsage_Vertex | WGPUBufferUsage_Storage | WGPUBufferUsage_CopyDst |
+                             WGPUBufferUsage_CopySrc;
+    vertexBufferA.reset(wgpuDeviceCreateBuffer(device, &vertexBufferDesc));
+    vertexBufferB.reset(wgpuDeviceCreateBuffer(device, &vertexBufferDesc));
+
+    // The particles are filled by uploadGeneratedPoints() or loadAsset()
+
+    // Uniforms and ellipse parameters are small, so they share allocator blocks
+    uniformBuffer = allocator.allocate(sizeof(UniformData));
+    ellipseBuffer = allocator.allocate(sizeof(EllipseParams) * MAX_ELLIPSES);
+
+    // Copy ellipse parameters (set up by initPoints) to buffer
+    allocator.write(ellipseBuffer, ellipseParams.data(), sizeof(EllipseParams) * MAX_ELLIPSES);
+
+    // Instance buffer, filled by setInstances()
+    createInstanceBuffer(1);
 }
 
-void PointWebSystem::createBindGroups() {
-    // First create render bind group (this part remains unchanged)
+void PointWebSystem::createRenderBindGroup() {
     if (!renderBindGroupLayout) {
         printf("Error: renderBindGroupLayout is null!\n");
         return;
     }
-
-    WGPUBindGroupEntry renderEntry = {};
-    renderEntry.binding = 0;
-    renderEntry.buffer = uniformBuffer;
-    renderEntry.offset = 0;
-    renderEntry.size = sizeof(UniformData);
+    // The previous bind group may still be referenced by a recorded bundle in flight
+    releaseQueue.retire(std::move(renderBindGroup));
+
+    WGPUBindGroupEntry renderEntries[2] = {};
+    renderEntries[0].binding = 0;
+    renderEntries[0].buffer = uniformBuffer.buffer;
+    renderEntries[0].offset = uniformBuffer.offset;
+    renderEntries[0].size = sizeof(UniformData);
+    renderEntries[1].binding = 1;
+    renderEntries[1].buffer = instanceBuffer.get();
+    renderEntries[1].offset = 0;
+    renderEntries[1].size = sizeof(GalaxyInstance) * instanceCapacity;
 
     WGPUBindGroupDescriptor renderBgDesc = {};
-    renderBgDesc.layout = renderBindGroupLayout;
-    renderBgDesc.entryCount = 1;
-    renderBgDesc.entries = &renderEntry;
+    renderBgDesc.layout = renderBindGroupLayout.get();
+    renderBgDesc.entryCount = 2;
+    renderBgDesc.entries = renderEntries;
 
-    renderBindGroup = wgpuDeviceCreateBindGroup(device, &renderBgDesc);
+    renderBindGroup.reset(wgpuDeviceCreateBindGroup(device, &renderBgDesc));
     if (!renderBindGroup) {
         printf("Failed to create render bind group!\n");
-        return;
     }
+}
 
-    // Create compute bind group layout first
-    WGPUBindGroupLayoutEntry computeEntries[3] = {};
-    // Input buffer
-    computeEntries[0].binding = 0;
-    computeEntries[0].visibility = WGPUShaderStage_Compute;
-    computeEntries[0].buffer.type = WGPUBufferBindingType_ReadOnlyStorage;
-    // Output buffer
-    computeEntries[1].binding = 1;
-    computeEntries[1].visibility = WGPUShaderStage_Compute;
-    computeEntries[1].buffer.type = WGPUBufferBindingType_Storage;
-    // Ellipse parameters buffer
-    computeEntries[2].binding = 2;
-    computeEntries[2].visibility = WGPUShaderStage_Compute;
-    computeEntries[2].buffer.type = WGPUBufferBindingType_ReadOnlyStorage;
-
-    WGPUBindGroupLayoutDescriptor computeBglDesc = {};
-    computeBglDesc.entryCount = 3;
-    computeBglDesc.entries = computeEntries;
-    computeBindGroupLayout = wgpuDeviceCreateBindGroupLayout(device, &computeBglDesc);
+void PointWebSystem::createBindGroups() {
+    createRenderBindGroup();
 
     // Create bind groups for compute shader
     {
         WGPUBindGroupEntry entriesA[3] = {};
         // Input buffer A
         entriesA[0].binding = 0;
-        entriesA[0].buffer = vertexBufferA;
+        entriesA[0].buffer = vertexBufferA.get();
         entriesA[0].offset = 0;
-        entriesA[0].size = sizeof(Point) * NUM_POINTS;
+        entriesA[0].size = sizeof(Point) * POINT_CAPACITY;
         // Output buffer B
         entriesA[1].binding = 1;
-        entriesA[1].buffer = vertexBufferB;
+        entriesA[1].buffer = vertexBufferB.get();
         entriesA[1].offset = 0;
-        entriesA[1].size = sizeof(Point) * NUM_POINTS;
+        entriesA[1].size = sizeof(Point) * POINT_CAPACITY;
         // Ellipse buffer
         entriesA[2].binding = 2;
-        entriesA[2].buffer = ellipseBuffer;
-        entriesA[2].offset = 0;
+        entriesA[2].buffer = ellipseBuffer.buffer;
+        entriesA[2].offset = ellipseBuffer.offset;
         entriesA[2].size = sizeof(EllipseParams) * MAX_ELLIPSES;
 
         WGPUBindGroupDescriptor bgDescA = {};
-        bgDescA.layout = computeBindGroupLayout;
+        bgDescA.layout = computeBindGroupLayout.get();
         bgDescA.entryCount = 3;
         bgDescA.entries = entriesA;
-        computeBindGroupA = wgpuDeviceCreateBindGroup(device, &bgDescA);
+        computeBindGroupA.reset(wgpuDeviceCreateBindGroup(device, &bgDescA));
     }
 
     // Create second bind group with swapped buffers
@@ -497,50 +306,174 @@ void PointWebSystem::createBindGroups() {
         WGPUBindGroupEntry entriesB[3] = {};
         // Input buffer B
         entriesB[0].binding = 0;
-        entriesB[0].buffer = vertexBufferB;
+        entriesB[0].buffer = vertexBufferB.get();
         entriesB[0].offset = 0;
-        entriesB[0].size = sizeof(Point) * NUM_POINTS;
+        entriesB[0].size = sizeof(Point) * POINT_CAPACITY;
         // Output buffer A
         entriesB[1].binding = 1;
-        entriesB[1].buffer = vertexBufferA;
+        entriesB[1].buffer = vertexBufferA.get();
         entriesB[1].offset = 0;
-        entriesB[1].size = sizeof(Point) * NUM_POINTS;
+        entriesB[1].size = sizeof(Point) * POINT_CAPACITY;
         // Ellipse buffer
         entriesB[2].binding = 2;
-        entriesB[2].buffer = ellipseBuffer;
-        entriesB[2].offset = 0;
+        entriesB[2].buffer = ellipseBuffer.buffer;
+        entriesB[2].offset = ellipseBuffer.offset;
         entriesB[2].size = sizeof(EllipseParams) * MAX_ELLIPSES;
 
         WGPUBindGroupDescriptor bgDescB = {};
-        bgDescB.layout = computeBindGroupLayout;
+        bgDescB.layout = computeBindGroupLayout.get();
         bgDescB.entryCount = 3;
         bgDescB.entries = entriesB;
-        computeBindGroupB = wgpuDeviceCreateBindGroup(device, &bgDescB);
+        computeBindGroupB.reset(wgpuDeviceCreateBindGroup(device, &bgDescB));
     }
 }
 
 
 void PointWebSystem::updateUniforms(const Camera& camera) {
-    uniformData.viewProj = camera.getProjection() * camera.getView();
+    if (camera.getVersion() == cameraVersion) return;
+    cameraVersion = camera.getVersion();
+
+    uniformData.viewProj = camera.getViewProjection();
     
-    wgpuQueueWriteBuffer(
-        wgpuDeviceGetQueue(device),
-        uniformBuffer,
-        0,
-        &uniformData,
-        sizeof(UniformData)
-    );
+    allocator.write(uniformBuffer, &uniformData, sizeof(UniformData));
 }
 
-void PointWebSystem::render(WGPURenderPassEncoder renderPass, const Camera& camera) {
+RenderBundleCache* PointWebSystem::getRenderBundle(const Camera& camera, BundleRecorder& recorder) {
+    WGPURenderPipeline pipeline = pipelines.getRenderPipeline(renderPipeline);
+    if (!pipeline || pendingParticleUploads > 0) return nullptr;
+
     updateUniforms(camera);
-    
-    wgpuRenderPassEncoderSetPipeline(renderPass, renderPipeline);
-    wgpuRenderPassEncoderSetBindGroup(renderPass, 0, renderBindGroup, 0, nullptr);
-    wgpuRenderPassEncoderSetVertexBuffer(renderPass, 0, 
-        useBufferA ? vertexBufferA : vertexBufferB, 0, sizeof(Point) * points.size());
-    wgpuRenderPassEncoderDraw(renderPass, NUM_POINTS, 1, 0, 0);
+
+    // One bundle per ping-pong buffer; both are recorded once and replayed on alternate frames
+    // until the pipeline or the instance set changes
+    int current = useBufferA ? 0 : 1;
+    uint64_t key = (uint64_t(pipelines.getVersion(renderPipeline)) << 32) | instanceGeneration;
+    if (bundles[current].isStale(key)) {
+        WGPUBuffer vertexBuffer = useBufferA ? vertexBufferA.get() : vertexBufferB.get();
+        uint64_t vertexSize = sizeof(Point) * POINT_CAPACITY;
+        uint32_t instanceCount = instances.size();
+        recorder.add(bundles[current], key, "Galaxy points",
+            [pipeline, bindGroup = renderBindGroup.get(), vertexBuffer, vertexSize, instanceCount](WGPURenderBundleEncoder encoder) {
+                wgpuRenderBundleEncoderSetPipeline(encoder, pipeline);
+                wgpuRenderBundleEncoderSetBindGroup(encoder, 0, bindGroup, 0, nullptr);
+                wgpuRenderBundleEncoderSetVertexBuffer(encoder, 0, vertexBuffer, 0, vertexSize);
+                wgpuRenderBundleEncoderDraw(encoder, POINT_CAPACITY, instanceCount, 0, 0);
+            });
+    }
 
     // Toggle buffers for next frame
     useBufferA = !useBufferA;
+    return &bundles[current];
+}
+
+// MARK: Ellipses
+void PointWebSystem::setEllipse(int index, const EllipseParams& params, uint32_t population) {
+    if (index < 0 || index >= MAX_ELLIPSES || asset) return;
+    population = std::min<uint32_t>(population, ELLIPSE_CAPACITY);
+
+    EllipseParams& current = ellipseParams[index];
+    bool reshaped = params.majorAxis != current.majorAxis || params.minorAxis != current.minorAxis ||
+                    params.tiltAngle != current.tiltAngle || population != ellipsePopulations[index];
+    current = params;
+    ellipsePopulations[index] = population;
+    allocator.write(ellipseBuffer, ellipseParams.data(), sizeof(EllipseParams) * MAX_ELLIPSES);
+
+    if (!reshaped) return;
+    uploadEllipse(index);
+    regeneratedCount += population;
+}
+
+void PointWebSystem::uploadEllipse(int ellipseIndex) {
+    // Both ping-pong buffers restart from the regenerated stars, generated from the parameters
+    // current when the upload is encoded
+    uint32_t firstSlot = uint32_t(ellipseIndex) * ELLIPSE_CAPACITY;
+    uploads.uploadGenerated({vertexBufferA.get(), vertexBufferB.get()}, uint64_t(firstSlot) * sizeof(Point),
+        sizeof(Point), ELLIPSE_CAPACITY, [this, firstSlot](uint64_t first, uint64_t count, void* out) {
+            generatePoints(firstSlot + first, count, static_cast<Point*>(out));
+        });
+}
+
+// MARK: Readback
+void PointWebSystem::readParticles(uint32_t first, uint32_t count,
+                                   std::function<void(const Point* points, uint32_t count)> onReady) {
+    first = std::min<uint32_t>(first, POINT_CAPACITY);
+    count = std::min<uint32_t>(count, POINT_CAPACITY - first);
+
+    // After a frame, the buffer the next render will draw from holds the latest simulation step
+    WGPUBuffer latest = useBufferA ? vertexBufferA.get() : vertexBufferB.get();
+    readback.request(latest, uint64_t(first) * sizeof(Point), uint64_t(count) * sizeof(Point),
+        [onReady](const void* data, uint64_t size) {
+            onReady(static_cast<const Point*>(data), data ? uint32_t(size / sizeof(Point)) : 0);
+        });
+}
+
+// MARK: Instances
+void PointWebSystem::createInstanceBuffer(size_t capacity) {
+    WGPUBufferDescriptor instanceDesc = {};
+    instanceDesc.label = "Galaxy instances";
+    instanceDesc.size = sizeof(GalaxyInstance) * capacity;
+    instanceDesc.usage = WGPUBufferUsage_Storage | WGPUBufferUsage_CopyDst;
+
+    // Hand the old buffer back to the pool once in-flight frames are done with it
+    if (instanceBuffer) {
+        releaseQueue.retireBuffer(std::move(instanceBuffer), sizeof(GalaxyInstance) * instanceCapacity, instanceDesc.usage);
+    }
+    instanceBuffer = releaseQueue.acquireBuffer(instanceDesc);
+    instanceCapacity = capacity;
+}
+
+void PointWebSystem::setInstances(const std::vector<GalaxyInstance>& newInstances) {
+    instances = newInstances;
+    if (instances.empty()) {
+        instanceGeneration++;
+        return;
+    }
+
+    // Grow geometrically so dragging the galaxy count doesn't reallocate every frame
+    if (instances.size() > instanceCapacity) {
+        createInstanceBuffer(std::max(instances.size(), instanceCapacity * 2));
+        createRenderBindGroup();
+    }
+
+    wgpuQueueWriteBuffer(
+        wgpuDeviceGetQueue(device),
+        instanceBuffer.get(),
+        0,
+        instances.data(),
+        sizeof(GalaxyInstance) * instances.size()
+    );
+    instanceGeneration++;
+}
+
+std::vector<GalaxyInstance> PointWebSystem::makeCluster(int count, float spacing) {
+    std::vector<GalaxyInstance> cluster(std::max(count, 0));
+    if (count == 1) return cluster;
+
+    int side = (int)std::ceil(std::sqrt((float)count));
+    float halfExtent = (side - 1) * spacing * 0.5f;
+    for (int i = 0; i < count; i++) {
+        GalaxyInstance& galaxy = cluster[i];
+        float jitterX = (GalaxyGenerator::hash(i * 3 + 0) - 0.5f) * spacing * 0.5f;
+        float jitterY = (GalaxyGenerator::hash(i * 3 + 1) - 0.5f) * spacing * 0.5f;
+        float jitterZ = (GalaxyGenerator::hash(i * 3 + 2) - 0.5f) * spacing * 0.5f;
+        glm::vec3 position((i % side) * spacing - halfExtent + jitterX,
+                           jitterY,
+                           (i / side) * spacing - halfExtent + jitterZ);
+
+        // Tilt the disc about a random horizontal axis and size it between 0.5x and 1x
+        float axisAngle = GalaxyGenerator::hash(i * 7 + 1) * 6.28318f;
+        glm::vec3 tiltAxis(std::cos(axisAngle), 0.0f, std::sin(axisAngle));
+        float tilt = GalaxyGenerator::hash(i * 7 + 2) * 0.8f;
+        float size = 0.5f + GalaxyGenerator::hash(i * 7 + 3) * 0.5f;
+        galaxy.model = glm::translate(glm::mat4(1.0f), position);
+        galaxy.model = glm::rotate(galaxy.model, tilt, tiltAxis);
+        galaxy.model = glm::scale(galaxy.model, glm::vec3(size));
+
+        galaxy.phase = GalaxyGenerator::hash(i * 11 + 5) * 6.28318f;
+        galaxy.tint = glm::vec4(0.7f + GalaxyGenerator::hash(i * 13 + 1) * 0.3f,
+                                0.7f + GalaxyGenerator::hash(i * 13 + 2) * 0.3f,
+                                0.7f + GalaxyGenerator::hash(i * 13 + 3) * 0.3f,
+                                1.0f);
+    }
+    return cluster;
 }
\ No newline at end of file
@@ -3,67 +3,129 @@
 #include <webgpu/webgpu.h>
 #include <vector>
 #include <memory>
+#include <functional>
 #include <glm/glm.hpp>
 #include "Camera.h"
-
-struct Point {
-    alignas(16) float position[3];  // x, y, z position
-    alignas(16) float velocity[3];  // x, y, z velocity
-};
+#include "PipelineManager.h"
+#include "RenderBundleCache.h"
+#include "BundleRecorder.h"
+#include "GpuHandle.h"
+#include "ReleaseQueue.h"
+#include "BufferAllocator.h"
+#include "UploadManager.h"
+#include "ReadbackManager.h"
+#include "GalaxyStatistics.h"
+#include "JobSystem.h"
+#include "GalaxyGenerator.h"
+#include "GalaxyAsset.h"
 
 struct UniformData {
     alignas(16) glm::mat4 viewProj;
 };
 
+// One drawn copy of the simulated galaxy. Every instance reads the same particle buffer,
+// so all of them together cost a single instanced draw.
+struct GalaxyInstance {
+    glm::mat4 model = glm::mat4(1.0f);
+    glm::vec4 tint = glm::vec4(1.0f);
+    float phase = 0.0f;  // Orbital phase offset (radians), so instances don't look identical
+    float padding[3] = {};
+};
+
 class PointWebSystem {
 public:
-    static constexpr int NUM_POINTS = 100000;
+    static constexpr int NUM_POINTS = GalaxyGenerator::NUM_POINTS;
     static constexpr int WORKGROUP_SIZE = 256;
-    static constexpr int MAX_ELLIPSES = 30;
+    static constexpr int MAX_ELLIPSES = GalaxyGenerator::MAX_ELLIPSES;
+    static constexpr int ELLIPSE_CAPACITY = GalaxyGenerator::ELLIPSE_CAPACITY;
+    static constexpr int POINT_CAPACITY = GalaxyGenerator::POINT_CAPACITY;
+    static constexpr float SIMULATION_STEP = 0.016f;  // Fixed step of galaxy_update.wgsl
 
-    PointWebSystem(WGPUDevice device);
+    PointWebSystem(WGPUDevice device, PipelineManager& pipelines, ReleaseQueue& releaseQueue,
+                   BufferAllocator& allocator, UploadManager& uploads, ReadbackManager& readback, JobSystem& jobs);
     ~PointWebSystem();
 
-    void render(WGPURenderPassEncoder renderPass, const Camera& camera);
+    // Updates uniforms and returns the cache holding the draw, queueing a re-record on the recorder
+    // when it is stale; nullptr while the pipeline compiles or the particles are still uploading
+    RenderBundleCache* getRenderBundle(const Camera& camera, BundleRecorder& recorder);
     void compute(WGPUComputePassEncoder computePass);
 
+    // Replaces the set of drawn galaxies; the instance buffer grows as needed
+    void setInstances(const std::vector<GalaxyInstance>& newInstances);
+    size_t getInstanceCount() const { return instances.size(); }
+
+    // Copies count simulated points starting at first back to the CPU; onReady runs a few
+    // frames later with points == nullptr if the readback failed
+    void readParticles(uint32_t first, uint32_t count, std::function<void(const Point* points, uint32_t count)> onReady);
+
+    GalaxyStatistics& getStatistics() { return *statistics; }
+
+    // Live ellipse editing. Speed changes only touch the parameter buffer; shape or population
+    // changes regenerate that ellipse's stars and upload just its slot range. Ignored while
+    // the initial conditions are still loading from an asset.
+    const EllipseParams& getEllipse(int index) const { return ellipseParams[index]; }
+    uint32_t getEllipsePopulation(int index) const { return ellipsePopulations[index]; }
+    void setEllipse(int index, const EllipseParams& params, uint32_t population);
+    size_t getRegeneratedCount() const { return regeneratedCount; }
+
+    // Lays out count galaxies on a jittered grid with random orientation, phase and tint
+    static std::vector<GalaxyInstance> makeCluster(int count, float spacing);
+
 private:
     static constexpr float POINT_SPACING = 1.0f;
-    WGPUBuffer ellipseBuffer = nullptr;
-    
-    // Add structure for ellipse parameters
-    struct EllipseParams {
-        float majorAxis;
-        float minorAxis;
-        float tiltAngle;
-    };
+    BufferAllocation ellipseBuffer;
     std::vector<EllipseParams> ellipseParams;
-    
+    std::vector<uint32_t> ellipsePopulations;
+    size_t regeneratedCount = 0;  // Stars regenerated by edits, for the UI
+
+    static constexpr uint32_t GENERATE_GRAIN = 8192;  // Points per generation job
+
     void createPipelineAndResources();
     void createComputePipeline();
     void createBuffers();
     void createBindGroups();
+    void createRenderBindGroup();
     void initPoints();
-    float hash(uint32_t n);
+    void generatePoints(uint32_t first, uint32_t count, Point* out);
+    void uploadGeneratedPoints();
+    void loadAsset(const char* path);
+    void uploadEllipse(int ellipseIndex);
     void updateUniforms(const Camera& camera);
+    void createInstanceBuffer(size_t capacity);
 
     WGPUDevice device;
+    PipelineManager& pipelines;
+    ReleaseQueue& releaseQueue;
+    BufferAllocator& allocator;
+    UploadManager& uploads;
+    ReadbackManager& readback;
+    JobSystem& jobs;
     
     // Graphics pipeline resources
-    WGPUBuffer vertexBufferA = nullptr;
-    WGPUBuffer vertexBufferB = nullptr;
-    WGPUBuffer uniformBuffer = nullptr;
-    WGPURenderPipeline renderPipeline = nullptr;
-    WGPUBindGroup renderBindGroup = nullptr;
-    WGPUBindGroupLayout renderBindGroupLayout = nullptr;
+    GpuBuffer vertexBufferA;
+    GpuBuffer vertexBufferB;
+    BufferAllocation uniformBuffer;
+    PipelineManager::Handle renderPipeline = PipelineManager::INVALID_HANDLE;
+    GpuBindGroup renderBindGroup;
+    GpuBindGroupLayout renderBindGroupLayout;
+    RenderBundleCache bundles[2];  // Drawing from buffer A / buffer B
+
+    // Per-galaxy instance data, read by the vertex shader through instance_index
+    GpuBuffer instanceBuffer;
+    size_t instanceCapacity = 0;
+    uint32_t instanceGeneration = 0;  // Bumped on every upload so bundles re-record
+    std::vector<GalaxyInstance> instances;
 
     // Compute pipeline resources
-    WGPUComputePipeline computePipeline = nullptr;
-    WGPUBindGroup computeBindGroupA = nullptr;  // For buffer A -> B
-    WGPUBindGroup computeBindGroupB = nullptr;  // For buffer B -> A
-    WGPUBindGroupLayout computeBindGroupLayout = nullptr;
+    PipelineManager::Handle computePipeline = PipelineManager::INVALID_HANDLE;
+    GpuBindGroup computeBindGroupA;  // For buffer A -> B
+    GpuBindGroup computeBindGroupB;  // For buffer B -> A
+    GpuBindGroupLayout computeBindGroupLayout;
 
     bool useBufferA = true;  // Toggle between buffers
-    std::vector<Point> points;
+    int pendingParticleUploads = 0;  // Particle buffers still streaming in
+    std::unique_ptr<GalaxyAsset> asset;  // Baked initial conditions, until all chunks have uploaded
+    std::unique_ptr<GalaxyStatistics> statistics;
     UniformData uniformData;
+    uint64_t cameraVersion = UINT64_MAX;  // Camera version last uploaded
 };
\ No newline at end of file
@@ -0,0 +1,108 @@
+#include "ReadbackManager.h"
+#include <cstdio>
+
+ReadbackManager::ReadbackManager(WGPUDevice device, AsyncPump& pump) : device(device), pump(pump) {}
+
+ReadbackManager::~ReadbackManager() {
+    // Late maps only free their request; pending callers are never called back
+    for (MapRequest* request : outstanding) {
+        request->owner = nullptr;
+    }
+}
+
+void ReadbackManager::request(WGPUBuffer src, uint64_t offset, uint64_t size, Callback onReady) {
+    if (offset % 4 != 0 || size % 4 != 0 || size == 0) {
+        printf("ReadbackManager: invalid range (offset %llu, size %llu)\n",
+            (unsigned long long)offset, (unsigned long long)size);
+        if (onReady) onReady(nullptr, 0);
+        return;
+    }
+    queued.push_back({src, offset, size, std::move(onReady)});
+}
+
+void ReadbackManager::cancel(WGPUBuffer src) {
+    for (auto it = queued.begin(); it != queued.end();) {
+        it = it->src == src ? queued.erase(it) : it + 1;
+    }
+    for (Staging& entry : staging) {
+        if (entry.state != StagingState::Free && entry.src == src) entry.onReady = nullptr;
+    }
+}
+
+size_t ReadbackManager::getInFlightCount() const {
+    size_t count = 0;
+    for (const Staging& entry : staging) {
+        if (entry.state != StagingState::Free) count++;
+    }
+    return count;
+}
+
+// MARK: Frame
+
+void ReadbackManager::encode(WGPUCommandEncoder encoder) {
+    for (Staging& entry : staging) {
+        if (queued.empty()) break;
+        if (entry.state != StagingState::Free) continue;
+
+        Request& next = queued.front();
+
+        // A free buffer is unmapped and no longer used by the GPU, so it can be replaced directly
+        if (entry.capacity < next.size) {
+            uint64_t capacity = MIN_STAGING_SIZE;
+            while (capacity < next.size) capacity *= 2;
+
+            WGPUBufferDescriptor stagingDesc = {};
+            stagingDesc.label = "Readback staging";
+            stagingDesc.size = capacity;
+            stagingDesc.usage = WGPUBufferUsage_MapRead | WGPUBufferUsage_CopyDst;
+            entry.buffer.reset(wgpuDeviceCreateBuffer(device, &stagingDesc));
+            entry.capacity = capacity;
+        }
+
+        wgpuCommandEncoderCopyBufferToBuffer(encoder, next.src, next.offset, entry.buffer.get(), 0, next.size);
+        entry.src = next.src;
+        entry.size = next.size;
+        entry.onReady = std::move(next.onReady);
+        entry.state = StagingState::Submitted;
+        queued.pop_front();
+    }
+}
+
+void ReadbackManager::endFrame() {
+    for (size_t i = 0; i < STAGING_COUNT; i++) {
+        if (staging[i].state != StagingState::Submitted) continue;
+
+        MapRequest* request = new MapRequest{this, i};
+        outstanding.insert(request);
+        staging[i].state = StagingState::Mapping;
+        pump.spawn(mapStaging(pump, staging[i].buffer.get(), staging[i].size, request));
+    }
+}
+
+Task<void> ReadbackManager::mapStaging(AsyncPump& pump, WGPUBuffer buffer, uint64_t size, MapRequest* request) {
+    WGPUBufferMapAsyncStatus status = co_await mapAsync(pump, buffer, WGPUMapMode_Read, 0, size);
+    if (ReadbackManager* self = request->owner) {
+        self->outstanding.erase(request);
+        self->onMapped(request->staging, status);
+    }
+    delete request;
+}
+
+void ReadbackManager::onMapped(size_t index, WGPUBufferMapAsyncStatus status) {
+    Staging& entry = staging[index];
+
+    // Detach first so the callback may queue the next readback
+    Callback onReady = std::move(entry.onReady);
+    entry.onReady = nullptr;
+
+    if (status == WGPUBufferMapAsyncStatus_Success) {
+        const void* data = wgpuBufferGetConstMappedRange(entry.buffer.get(), 0, entry.size);
+        if (onReady) onReady(data, entry.size);
+        wgpuBufferUnmap(entry.buffer.get());
+        completedCount++;
+    } else {
+        printf("ReadbackManager: failed to map staging buffer %zu (status %d)\n", index, (int)status);
+        if (onReady) onReady(nullptr, 0);
+    }
+    entry.state = StagingState::Free;
+}
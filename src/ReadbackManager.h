@@ -0,0 +1,87 @@
+#pragma once
+
+#include <webgpu/webgpu.h>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <unordered_set>
+#include <vector>
+#include "GpuHandle.h"
+#include "GpuAsync.h"
+
+// Copies byte ranges of device buffers back to the CPU without stalling the frame.
+//
+// Each request is recorded into one of three MapRead staging buffers by encode(), mapped by a
+// coroutine awaiting mapAsync after the frame is submitted, and handed to its callback when
+// the async pump resumes it, a few frames later. With three buffers a caller can keep one readback in
+// flight per frame at full frame rate; further requests wait for a free buffer.
+class ReadbackManager {
+public:
+    // data is only valid during the call; it is nullptr if the readback failed
+    using Callback = std::function<void(const void* data, uint64_t size)>;
+
+    ReadbackManager(WGPUDevice device, AsyncPump& pump);
+    ~ReadbackManager();
+
+    ReadbackManager(const ReadbackManager&) = delete;
+    ReadbackManager& operator=(const ReadbackManager&) = delete;
+
+    // Queues a readback of size bytes of src at offset; both must be multiples of 4.
+    // src needs CopySrc usage and must stay alive until the request is encoded or cancelled.
+    void request(WGPUBuffer src, uint64_t offset, uint64_t size, Callback onReady);
+
+    // Drops queued requests from src and silences the callbacks of those already in flight
+    void cancel(WGPUBuffer src);
+
+    // Records copies for queued requests into free staging buffers
+    void encode(WGPUCommandEncoder encoder);
+
+    // Starts mapping the staging buffers recorded this frame; call after the frame is submitted
+    void endFrame();
+
+    size_t getQueuedCount() const { return queued.size(); }
+    size_t getInFlightCount() const;
+    size_t getCompletedCount() const { return completedCount; }
+
+private:
+    enum class StagingState {
+        Free,
+        Submitted,  // Copy recorded this frame, waiting for endFrame()
+        Mapping,    // mapStaging() waiting for the map
+    };
+
+    struct Request {
+        WGPUBuffer src;
+        uint64_t offset;
+        uint64_t size;
+        Callback onReady;
+    };
+
+    struct Staging {
+        GpuBuffer buffer;
+        uint64_t capacity = 0;
+        StagingState state = StagingState::Free;
+        WGPUBuffer src = nullptr;  // Only compared against in cancel()
+        uint64_t size = 0;  // Bytes copied for the current request
+        Callback onReady;
+    };
+
+    // Heap-allocated state shared with a map coroutine, detached on destruction
+    struct MapRequest {
+        ReadbackManager* owner;
+        size_t staging;
+    };
+
+    static Task<void> mapStaging(AsyncPump& pump, WGPUBuffer buffer, uint64_t size, MapRequest* request);
+    void onMapped(size_t index, WGPUBufferMapAsyncStatus status);
+
+    static constexpr size_t STAGING_COUNT = 3;
+    static constexpr uint64_t MIN_STAGING_SIZE = 64 * 1024;
+
+    WGPUDevice device;
+    AsyncPump& pump;
+    Staging staging[STAGING_COUNT];
+    std::deque<Request> queued;
+    std::unordered_set<MapRequest*> outstanding;
+    size_t completedCount = 0;
+};
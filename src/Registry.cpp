@@ -0,0 +1,90 @@
+#include "Registry.h"
+
+Archetype& Registry::findOrCreateArchetype(uint32_t mask, uint32_t& index) {
+    for (uint32_t i = 0; i < archetypes.size(); i++) {
+        if (archetypes[i].mask == mask) {
+            index = i;
+            return archetypes[i];
+        }
+    }
+    index = (uint32_t)archetypes.size();
+    archetypes.push_back({});
+    archetypes.back().mask = mask;
+    return archetypes.back();
+}
+
+Entity Registry::create(uint32_t mask) {
+    Entity entity;
+    if (!freeEntities.empty()) {
+        entity = freeEntities.back();
+        freeEntities.pop_back();
+    } else {
+        entity = (Entity)locations.size();
+        locations.push_back({});
+    }
+
+    uint32_t index;
+    Archetype& archetype = findOrCreateArchetype(mask, index);
+    locations[entity] = {index, (uint32_t)archetype.size()};
+
+    archetype.entities.push_back(entity);
+    if (mask & COMPONENT_TRANSFORM) archetype.transforms.emplace_back();
+    if (mask & COMPONENT_RENDERABLE) archetype.renderables.emplace_back();
+    if (mask & COMPONENT_SIMULATION) archetype.simulations.emplace_back();
+
+    entityCount++;
+    version++;
+    return entity;
+}
+
+void Registry::destroy(Entity entity) {
+    uint32_t row;
+    Archetype* archetype = archetypeOf(entity, row);
+    if (!archetype) return;
+
+    // Swap-remove keeps the arrays dense; the last entity takes over the freed row
+    auto swapRemove = [row](auto& components) {
+        if (components.empty()) return;
+        components[row] = components.back();
+        components.pop_back();
+    };
+    Entity moved = archetype->entities.back();
+    swapRemove(archetype->entities);
+    swapRemove(archetype->transforms);
+    swapRemove(archetype->renderables);
+    swapRemove(archetype->simulations);
+    if (moved != entity) locations[moved].row = row;
+
+    locations[entity] = {};
+    freeEntities.push_back(entity);
+    entityCount--;
+    version++;
+}
+
+bool Registry::isAlive(Entity entity) const {
+    return entity < locations.size() && locations[entity].archetype != UINT32_MAX;
+}
+
+Archetype* Registry::archetypeOf(Entity entity, uint32_t& row) {
+    if (!isAlive(entity)) return nullptr;
+    row = locations[entity].row;
+    return &archetypes[locations[entity].archetype];
+}
+
+Transform* Registry::getTransform(Entity entity) {
+    uint32_t row;
+    Archetype* archetype = archetypeOf(entity, row);
+    return archetype && archetype->has(COMPONENT_TRANSFORM) ? &archetype->transforms[row] : nullptr;
+}
+
+Renderable* Registry::getRenderable(Entity entity) {
+    uint32_t row;
+    Archetype* archetype = archetypeOf(entity, row);
+    return archetype && archetype->has(COMPONENT_RENDERABLE) ? &archetype->renderables[row] : nullptr;
+}
+
+Simulation* Registry::getSimulation(Entity entity) {
+    uint32_t row;
+    Archetype* archetype = archetypeOf(entity, row);
+    return archetype && archetype->has(COMPONENT_SIMULATION) ? &archetype->simulations[row] : nullptr;
+}
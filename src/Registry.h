@@ -0,0 +1,94 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+
+using Entity = uint32_t;
+constexpr Entity INVALID_ENTITY = UINT32_MAX;
+
+// MARK: Components
+
+struct Transform {
+    glm::mat4 model = glm::mat4(1.0f);
+};
+
+enum class RenderableKind : uint8_t {
+    Galaxy,
+    Grid,
+    Triangle,
+};
+
+struct Renderable {
+    RenderableKind kind = RenderableKind::Galaxy;
+    glm::vec4 tint = glm::vec4(1.0f);
+};
+
+struct Simulation {
+    float phase = 0.0f;  // Orbital phase offset (radians), fixed when the entity is created
+};
+
+enum ComponentMask : uint32_t {
+    COMPONENT_TRANSFORM  = 1 << 0,
+    COMPONENT_RENDERABLE = 1 << 1,
+    COMPONENT_SIMULATION = 1 << 2,
+};
+
+// Every entity with the same set of components lives in the same archetype, with each
+// component stored in its own contiguous array. Arrays for components the archetype
+// doesn't have stay empty. Row i of every array belongs to entities[i].
+struct Archetype {
+    uint32_t mask = 0;
+    std::vector<Entity> entities;
+    std::vector<Transform> transforms;
+    std::vector<Renderable> renderables;
+    std::vector<Simulation> simulations;
+
+    size_t size() const { return entities.size(); }
+    bool has(uint32_t components) const { return (mask & components) == components; }
+};
+
+// Archetype-based entity/component storage. Systems iterate archetypes with forEach() and
+// walk the component arrays directly instead of looking entities up one at a time.
+class Registry {
+public:
+    Entity create(uint32_t mask);
+    void destroy(Entity entity);
+    bool isAlive(Entity entity) const;
+
+    // Returns nullptr if the entity doesn't have the component
+    Transform* getTransform(Entity entity);
+    Renderable* getRenderable(Entity entity);
+    Simulation* getSimulation(Entity entity);
+
+    // Calls fn(Archetype&) for every non-empty archetype that has all of the given components
+    template <typename Fn>
+    void forEach(uint32_t components, Fn&& fn) {
+        for (Archetype& archetype : archetypes) {
+            if (archetype.has(components) && archetype.size() > 0) fn(archetype);
+        }
+    }
+
+    size_t getEntityCount() const { return entityCount; }
+    size_t getArchetypeCount() const { return archetypes.size(); }
+
+    // Bumped on structural changes, so systems can skip rebuilding derived data (e.g. GPU
+    // instance buffers) when nothing changed. Components are written only right after
+    // create(), which already bumped it.
+    uint64_t getVersion() const { return version; }
+
+private:
+    struct Location {
+        uint32_t archetype = UINT32_MAX;
+        uint32_t row = 0;
+    };
+
+    Archetype& findOrCreateArchetype(uint32_t mask, uint32_t& index);
+    Archetype* archetypeOf(Entity entity, uint32_t& row);
+
+    std::vector<Archetype> archetypes;
+    std::vector<Location> locations;  // Indexed by entity
+    std::vector<Entity> freeEntities;
+    size_t entityCount = 0;
+    uint64_t version = 0;
+};
@@ -0,0 +1,87 @@
+#include "ReleaseQueue.h"
+#include <algorithm>
+
+ReleaseQueue::ReleaseQueue(WGPUDevice device) : device(device) {}
+
+ReleaseQueue::~ReleaseQueue() {
+    // Late callbacks only free their fence
+    for (Fence* fence : outstanding) {
+        fence->owner = nullptr;
+    }
+
+    // The device outlives us and keeps in-flight resources alive on its own
+    for (const Retired& retired : pending) {
+        retired.release(retired.handle);
+    }
+    for (const PooledBuffer& entry : pendingBuffers) {
+        wgpuBufferRelease(entry.buffer);
+    }
+    for (const PooledBuffer& entry : pool) {
+        wgpuBufferRelease(entry.buffer);
+    }
+}
+
+void ReleaseQueue::retireBuffer(GpuBuffer&& buffer, uint64_t size, WGPUBufferUsageFlags usage) {
+    if (!buffer) return;
+    pendingBuffers.push_back({currentFrame, buffer.release(), size, usage});
+}
+
+GpuBuffer ReleaseQueue::acquireBuffer(const WGPUBufferDescriptor& desc) {
+    if (!desc.mappedAtCreation) {
+        for (size_t i = 0; i < pool.size(); i++) {
+            if (pool[i].size != desc.size || pool[i].usage != desc.usage) continue;
+
+            WGPUBuffer buffer = pool[i].buffer;
+            pooledBytes -= pool[i].size;
+            pool.erase(pool.begin() + i);
+            poolHits++;
+            return GpuBuffer(buffer);
+        }
+    }
+
+    poolMisses++;
+    return GpuBuffer(wgpuDeviceCreateBuffer(device, &desc));
+}
+
+void ReleaseQueue::collect() {
+    while (!pending.empty() && pending.front().frame <= completedFrame) {
+        pending.front().release(pending.front().handle);
+        pending.pop_front();
+    }
+
+    while (!pendingBuffers.empty() && pendingBuffers.front().frame <= completedFrame) {
+        pool.push_back(pendingBuffers.front());
+        pooledBytes += pendingBuffers.front().size;
+        pendingBuffers.pop_front();
+    }
+    trimPool();
+}
+
+void ReleaseQueue::trimPool() {
+    size_t released = 0;
+    while (pooledBytes > MAX_POOLED_BYTES && released < pool.size()) {
+        wgpuBufferRelease(pool[released].buffer);
+        pooledBytes -= pool[released].size;
+        released++;
+    }
+    pool.erase(pool.begin(), pool.begin() + released);
+}
+
+void ReleaseQueue::endFrame(WGPUQueue queue) {
+    Fence* fence = new Fence{this, currentFrame};
+    outstanding.insert(fence);
+    wgpuQueueOnSubmittedWorkDone(queue, onWorkDone, fence);
+    currentFrame++;
+}
+
+void ReleaseQueue::onWorkDone(WGPUQueueWorkDoneStatus status, void* userdata) {
+    Fence* fence = static_cast<Fence*>(userdata);
+    ReleaseQueue* self = fence->owner;
+    if (self) {
+        self->outstanding.erase(fence);
+        // Even on device loss nothing is left to wait for, so the frame counts as done
+        (void)status;
+        self->completedFrame = std::max(self->completedFrame, fence->frame);
+    }
+    delete fence;
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <webgpu/webgpu.h>
+#include <cstdint>
+#include <deque>
+#include <unordered_set>
+#include <vector>
+#include "GpuHandle.h"
+
+// Defers releasing resources until the GPU has finished every frame that could still use them,
+// and recycles retired buffers into a pool keyed by size and usage.
+//
+// Frames are fenced with wgpuQueueOnSubmittedWorkDone: endFrame() after each submit tags the
+// frame and collect() at the start of the next one releases or pools whatever has completed.
+class ReleaseQueue {
+public:
+    explicit ReleaseQueue(WGPUDevice device);
+    ~ReleaseQueue();
+
+    ReleaseQueue(const ReleaseQueue&) = delete;
+    ReleaseQueue& operator=(const ReleaseQueue&) = delete;
+
+    // Releases the handle once the frame being recorded has completed on the GPU
+    template <typename T>
+    void retire(GpuHandle<T>&& handle) {
+        if (!handle) return;
+        pending.push_back({currentFrame, handle.release(), [](void* raw) {
+            GpuHandleTraits<T>::release(static_cast<T>(raw));
+        }});
+    }
+
+    // Returns the buffer to the pool once the frame being recorded has completed.
+    // size and usage must match the descriptor it was created with.
+    void retireBuffer(GpuBuffer&& buffer, uint64_t size, WGPUBufferUsageFlags usage);
+
+    // Reuses a pooled buffer with the same size and usage, or creates a new one.
+    // Buffers mapped at creation always come fresh from the device.
+    GpuBuffer acquireBuffer(const WGPUBufferDescriptor& desc);
+
+    void collect();
+    void endFrame(WGPUQueue queue);
+
+    uint64_t getPooledBytes() const { return pooledBytes; }
+    size_t getPoolHits() const { return poolHits; }
+    size_t getPoolMisses() const { return poolMisses; }
+    size_t getPendingCount() const { return pending.size() + pendingBuffers.size(); }
+
+private:
+    struct Retired {
+        uint64_t frame;
+        void* handle;
+        void (*release)(void*);
+    };
+
+    struct PooledBuffer {
+        uint64_t frame;
+        WGPUBuffer buffer;
+        uint64_t size;
+        WGPUBufferUsageFlags usage;
+    };
+
+    // Heap-allocated userdata for the work-done callback, detached on destruction
+    struct Fence {
+        ReleaseQueue* owner;
+        uint64_t frame;
+    };
+
+    static void onWorkDone(WGPUQueueWorkDoneStatus status, void* userdata);
+    void trimPool();
+
+    // Upper bound on idle pooled memory; the oldest buffers are released beyond it
+    static constexpr uint64_t MAX_POOLED_BYTES = 64ull * 1024 * 1024;
+
+    WGPUDevice device;
+    uint64_t currentFrame = 1;
+    uint64_t completedFrame = 0;
+
+    std::deque<Retired> pending;
+    std::deque<PooledBuffer> pendingBuffers;
+    std::vector<PooledBuffer> pool;  // Oldest first
+    std::unordered_set<Fence*> outstanding;
+
+    uint64_t pooledBytes = 0;
+    size_t poolHits = 0;
+    size_t poolMisses = 0;
+};
@@ -0,0 +1,36 @@
+#include "RenderBundleCache.h"
+
+std::atomic<size_t> RenderBundleCache::recordCount{0};
+
+RenderBundleCache::~RenderBundleCache() {
+    invalidate();
+}
+
+WGPURenderBundleEncoder RenderBundleCache::begin(WGPUDevice device, WGPUTextureFormat colorFormat, const char* label) {
+    this->label = label;
+
+    WGPURenderBundleEncoderDescriptor encoderDesc = {};
+    encoderDesc.label = label;
+    encoderDesc.colorFormatCount = 1;
+    encoderDesc.colorFormats = &colorFormat;
+    encoderDesc.depthStencilFormat = WGPUTextureFormat_Undefined;
+    encoderDesc.sampleCount = 1;
+    return wgpuDeviceCreateRenderBundleEncoder(device, &encoderDesc);
+}
+
+void RenderBundleCache::finish(WGPURenderBundleEncoder encoder, uint64_t key) {
+    invalidate();
+
+    WGPURenderBundleDescriptor bundleDesc = {};
+    bundleDesc.label = label;
+    bundle = wgpuRenderBundleEncoderFinish(encoder, &bundleDesc);
+    wgpuRenderBundleEncoderRelease(encoder);
+
+    recordedKey = key;
+    recordCount++;
+}
+
+void RenderBundleCache::invalidate() {
+    if (bundle) wgpuRenderBundleRelease(bundle);
+    bundle = nullptr;
+}
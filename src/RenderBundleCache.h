@@ -0,0 +1,35 @@
+#pragma once
+
+#include <webgpu/webgpu.h>
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+
+// Holds a render bundle recorded for a given key (pipeline version, buffer generation...).
+// Renderers re-record only when the key changes and otherwise replay the cached bundle.
+class RenderBundleCache {
+public:
+    RenderBundleCache() = default;
+    ~RenderBundleCache();
+
+    RenderBundleCache(const RenderBundleCache&) = delete;
+    RenderBundleCache& operator=(const RenderBundleCache&) = delete;
+
+    bool isStale(uint64_t key) const { return !bundle || key != recordedKey; }
+
+    WGPURenderBundleEncoder begin(WGPUDevice device, WGPUTextureFormat colorFormat, const char* label);
+    void finish(WGPURenderBundleEncoder encoder, uint64_t key);
+    void invalidate();
+
+    WGPURenderBundle get() const { return bundle; }
+
+    // Number of bundles recorded across all caches, for profiling re-record churn
+    static size_t getRecordCount() { return recordCount; }
+
+private:
+    WGPURenderBundle bundle = nullptr;
+    uint64_t recordedKey = 0;
+    const char* label = nullptr;
+
+    static std::atomic<size_t> recordCount;  // Caches may be recorded from worker threads
+};
@@ -0,0 +1,72 @@
+#include "RenderThread.h"
+#include <chrono>
+
+// MARK: UiSnapshot
+
+UiSnapshot::UiSnapshot(const ImDrawData* source) {
+    drawData = *source;
+    drawData.OwnerViewport = nullptr;
+    for (ImDrawList*& list : drawData.CmdLists) {
+        list = list->CloneOutput();
+    }
+}
+
+UiSnapshot::~UiSnapshot() {
+    for (ImDrawList* list : drawData.CmdLists) {
+        IM_DELETE(list);
+    }
+}
+
+// MARK: RenderThread
+
+RenderThread::RenderThread(RenderFunction render, size_t capacity)
+    : render(std::move(render)), capacity(capacity) {
+    thread = std::thread(&RenderThread::run, this);
+}
+
+RenderThread::~RenderThread() {
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        stopping = true;
+        queueChanged.notify_all();
+        queueChanged.wait(lock, [this] { return queue.empty() && !rendering; });
+    }
+    thread.join();
+    finished.clear();
+}
+
+void RenderThread::submit(FramePacket packet) {
+    std::deque<FramePacket> done;
+    auto waitStart = std::chrono::steady_clock::now();
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        queueChanged.wait(lock, [this] { return queue.size() < capacity; });
+        queue.push_back(std::move(packet));
+        done.swap(finished);
+        queueChanged.notify_all();
+    }
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - waitStart).count();
+    waitMs += (ms - waitMs) * 0.05;
+    // done is destroyed here, on the submitting thread
+}
+
+void RenderThread::run() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        queueChanged.wait(lock, [this] { return !queue.empty() || stopping; });
+        if (queue.empty()) break;
+
+        // The packet stays at the front, counting against the capacity, while it is rendered;
+        // deque references survive the submitter pushing behind it
+        FramePacket& packet = queue.front();
+        rendering = true;
+        lock.unlock();
+        render(packet);
+        lock.lock();
+
+        finished.push_back(std::move(queue.front()));
+        queue.pop_front();
+        rendering = false;
+        queueChanged.notify_all();
+    }
+}
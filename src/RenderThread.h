@@ -0,0 +1,98 @@
+#pragma once
+
+#include "imgui.h"
+#include "Camera.h"
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Deep copy of one frame's ImDrawData, so it can be drawn while ImGui builds the next frame
+class UiSnapshot {
+public:
+    explicit UiSnapshot(const ImDrawData* source);
+    ~UiSnapshot();
+
+    UiSnapshot(const UiSnapshot&) = delete;
+    UiSnapshot& operator=(const UiSnapshot&) = delete;
+
+    ImDrawData* get() { return &drawData; }
+
+private:
+    ImDrawData drawData;
+};
+
+// Engine options edited by the UI. The main thread owns them and every frame packet carries
+// a copy, which the render side applies before it updates.
+struct EngineSettings {
+    bool dynamicResolution = false;
+    float resolutionBudgetMs = 16.6f;
+    float minResolutionScale = 0.5f;
+    bool parallelEncoding = false;
+    bool computeStatistics = true;
+    float histogramRadius = 40.0f;
+    bool sampleParticles = false;
+};
+
+// Everything the render side needs from one main-thread frame. It is immutable once submitted.
+// The render side owns the engine objects: the UI changes them only through settings and
+// commands, and reads them only from a copy the render side publishes after each frame.
+struct FramePacket {
+    Camera camera;
+    int framebufferWidth = 0;
+    int framebufferHeight = 0;
+    float deltaTime = 0.0f;
+    ImVec4 clearColor;
+    EngineSettings settings;
+    // One-off UI edits (adding galaxies, reshaping an ellipse), run in order before the update
+    std::vector<std::function<void()>> commands;
+
+    bool uiRebuilt = false;  // The UI was rebuilt this frame and the cached layer needs re-rendering
+    bool uiCached = false;   // Composite the cached UI layer instead of drawing drawData directly
+    ImDrawData* drawData = nullptr;
+    std::shared_ptr<UiSnapshot> uiSnapshot;  // Owns drawData when rendering on another thread
+};
+
+// Runs a render function for submitted frame packets on a dedicated thread.
+//
+// The queue is bounded, so the submitting thread runs at most `capacity` frames ahead and
+// blocks when the render side falls behind. Rendered packets are handed back and destroyed
+// on the submitting thread, since ImGui's allocator bookkeeping is not thread-safe.
+class RenderThread {
+public:
+    using RenderFunction = std::function<void(const FramePacket&)>;
+
+    explicit RenderThread(RenderFunction render, size_t capacity = 1);
+    // Renders the packets still queued, then joins
+    ~RenderThread();
+
+    RenderThread(const RenderThread&) = delete;
+    RenderThread& operator=(const RenderThread&) = delete;
+
+    // Queues a packet, waiting while the queue is full
+    void submit(FramePacket packet);
+
+    // Time the submitting thread spent waiting for room in the queue, averaged over recent frames
+    double getWaitMs() const { return waitMs; }
+
+private:
+    void run();
+
+    RenderFunction render;
+    size_t capacity;
+
+    std::mutex mutex;
+    std::condition_variable queueChanged;
+    std::deque<FramePacket> queue;
+    std::deque<FramePacket> finished;
+    bool rendering = false;
+    bool stopping = false;
+
+    double waitMs = 0.0;
+
+    std::thread thread;
+};
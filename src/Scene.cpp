@@ -0,0 +1,117 @@
+#include "Scene.h"
+
+Scene::Scene(WGPUDevice device, PipelineManager& pipelines, ReleaseQueue& releaseQueue, BufferAllocator& allocator,
+             UploadManager& uploads, ReadbackManager& readback, JobSystem& jobs)
+    : device(device), pipelines(pipelines), releaseQueue(releaseQueue), allocator(allocator), uploads(uploads),
+      readback(readback), jobs(jobs), bundleRecorder(jobs) {}
+
+// MARK: Entities
+
+Entity Scene::addGalaxy(const glm::mat4& model, const glm::vec4& tint, float phase) {
+    Entity entity = registry.create(COMPONENT_TRANSFORM | COMPONENT_RENDERABLE | COMPONENT_SIMULATION);
+    registry.getTransform(entity)->model = model;
+    *registry.getRenderable(entity) = {RenderableKind::Galaxy, tint};
+    registry.getSimulation(entity)->phase = phase;
+    return entity;
+}
+
+Entity Scene::addGrid() {
+    Entity entity = registry.create(COMPONENT_RENDERABLE);
+    registry.getRenderable(entity)->kind = RenderableKind::Grid;
+    return entity;
+}
+
+void Scene::removeAll(RenderableKind kind) {
+    std::vector<Entity> doomed;
+    registry.forEach(COMPONENT_RENDERABLE, [&](Archetype& archetype) {
+        for (size_t i = 0; i < archetype.size(); i++) {
+            if (archetype.renderables[i].kind == kind) doomed.push_back(archetype.entities[i]);
+        }
+    });
+    for (Entity entity : doomed) {
+        registry.destroy(entity);
+    }
+}
+
+// MARK: Renderers
+
+PointWebSystem& Scene::getPointSystem() {
+    if (!pointSystem) pointSystem = std::make_unique<PointWebSystem>(device, pipelines, releaseQueue, allocator, uploads, readback, jobs);
+    return *pointSystem;
+}
+
+GridRenderer& Scene::getGridRenderer() {
+    if (!gridRenderer) gridRenderer = std::make_unique<GridRenderer>(device, pipelines, allocator);
+    return *gridRenderer;
+}
+
+TriangleRenderer& Scene::getTriangleRenderer() {
+    if (!triangleRenderer) triangleRenderer = std::make_unique<TriangleRenderer>(device, pipelines, allocator);
+    return *triangleRenderer;
+}
+
+// MARK: Systems
+
+void Scene::update(float deltaTime) {
+    if (triangleRenderer) triangleRenderer->update(deltaTime);
+}
+
+void Scene::syncGalaxyInstances() {
+    if (registry.getVersion() == syncedVersion) return;
+    syncedVersion = registry.getVersion();
+
+    galaxyInstances.clear();
+    for (size_t& count : renderableCounts) count = 0;
+
+    registry.forEach(COMPONENT_RENDERABLE, [&](Archetype& archetype) {
+        bool hasTransform = archetype.has(COMPONENT_TRANSFORM);
+        bool hasSimulation = archetype.has(COMPONENT_SIMULATION);
+        for (size_t i = 0; i < archetype.size(); i++) {
+            const Renderable& renderable = archetype.renderables[i];
+            renderableCounts[(size_t)renderable.kind]++;
+            if (renderable.kind != RenderableKind::Galaxy) continue;
+
+            GalaxyInstance instance;
+            if (hasTransform) instance.model = archetype.transforms[i].model;
+            if (hasSimulation) instance.phase = archetype.simulations[i].phase;
+            instance.tint = renderable.tint;
+            galaxyInstances.push_back(instance);
+        }
+    });
+
+    if (!galaxyInstances.empty() || pointSystem) {
+        getPointSystem().setInstances(galaxyInstances);
+    }
+}
+
+void Scene::compute(WGPUComputePassEncoder computePass) {
+    syncGalaxyInstances();
+    if (renderableCounts[(size_t)RenderableKind::Galaxy] > 0) getPointSystem().compute(computePass);
+}
+
+bool Scene::readParticles(uint32_t first, uint32_t count,
+                          std::function<void(const Point* points, uint32_t count)> onReady) {
+    if (!pointSystem) return false;
+    pointSystem->readParticles(first, count, std::move(onReady));
+    return true;
+}
+
+void Scene::collectRenderBundles(const Camera& camera, std::vector<WGPURenderBundle>& bundles) {
+    syncGalaxyInstances();
+
+    // Uniform uploads and bundle bookkeeping stay on this thread; only stale bundles are
+    // handed to the recorder. Grid last so its lines blend over the stars.
+    RenderBundleCache* caches[3] = {};
+    if (renderableCounts[(size_t)RenderableKind::Galaxy] > 0)
+        caches[0] = getPointSystem().getRenderBundle(camera, bundleRecorder);
+    if (renderableCounts[(size_t)RenderableKind::Triangle] > 0)
+        caches[1] = getTriangleRenderer().getRenderBundle(camera, bundleRecorder);
+    if (renderableCounts[(size_t)RenderableKind::Grid] > 0)
+        caches[2] = getGridRenderer().getRenderBundle(camera, bundleRecorder);
+
+    // Joined in draw order whichever thread recorded them
+    bundleRecorder.record(device, SCENE_COLOR_FORMAT);
+    for (RenderBundleCache* cache : caches) {
+        if (cache && cache->get()) bundles.push_back(cache->get());
+    }
+}
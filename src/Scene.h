@@ -0,0 +1,77 @@
+#pragma once
+
+#include <webgpu/webgpu.h>
+#include <memory>
+#include <vector>
+#include "Camera.h"
+#include "PipelineManager.h"
+#include "PointWebSystem.h"
+#include "GridRenderer.h"
+#include "TriangleRenderer.h"
+#include "Registry.h"
+#include "ReleaseQueue.h"
+#include "BundleRecorder.h"
+
+// Owns the entity registry and the systems that turn its components into GPU work.
+// Renderers are created the first time an entity needs them, so subsystems with no
+// entities cost nothing (no buffers, no pipeline compiles).
+class Scene {
+public:
+    Scene(WGPUDevice device, PipelineManager& pipelines, ReleaseQueue& releaseQueue, BufferAllocator& allocator,
+          UploadManager& uploads, ReadbackManager& readback, JobSystem& jobs);
+
+    Registry& getRegistry() { return registry; }
+
+    Entity addGalaxy(const glm::mat4& model, const glm::vec4& tint = glm::vec4(1.0f), float phase = 0.0f);
+    Entity addGrid();
+    void removeAll(RenderableKind kind);
+
+    // Advances the renderers' CPU-side animation; galaxy phases are static per entity
+    void update(float deltaTime);
+
+    // Records GPU simulation work for every subsystem that has entities
+    void compute(WGPUComputePassEncoder computePass);
+
+    // Reads back simulated particles; false if no galaxy system exists yet
+    bool readParticles(uint32_t first, uint32_t count, std::function<void(const Point* points, uint32_t count)> onReady);
+
+    // The galaxy simulation for live editing, or nullptr if no galaxy system exists yet
+    PointWebSystem* getGalaxySystem() { return pointSystem.get(); }
+
+    // Statistics of the simulated galaxy, or nullptr if no galaxy system exists yet
+    GalaxyStatistics* getGalaxyStatistics() { return pointSystem ? &pointSystem->getStatistics() : nullptr; }
+
+    // Render system: appends one bundle per active renderer, in draw order
+    void collectRenderBundles(const Camera& camera, std::vector<WGPURenderBundle>& bundles);
+
+    // Records stale bundles on the job system; only enable on devices with implicit synchronization
+    void setParallelEncoding(bool enabled) { bundleRecorder.parallel = enabled; }
+    const BundleRecorder& getBundleRecorder() const { return bundleRecorder; }
+
+private:
+    PointWebSystem& getPointSystem();
+    GridRenderer& getGridRenderer();
+    TriangleRenderer& getTriangleRenderer();
+
+    // Rebuilds the galaxy instance buffer when the registry changed since the last upload
+    void syncGalaxyInstances();
+
+    WGPUDevice device;
+    PipelineManager& pipelines;
+    ReleaseQueue& releaseQueue;
+    BufferAllocator& allocator;
+    UploadManager& uploads;
+    ReadbackManager& readback;
+    JobSystem& jobs;
+    Registry registry;
+
+    std::unique_ptr<PointWebSystem> pointSystem;
+    std::unique_ptr<GridRenderer> gridRenderer;
+    std::unique_ptr<TriangleRenderer> triangleRenderer;
+    BundleRecorder bundleRecorder;
+
+    // Per-kind entity counts and the instances gathered from them, rebuilt on change
+    size_t renderableCounts[3] = {};
+    std::vector<GalaxyInstance> galaxyInstances;
+    uint64_t syncedVersion = UINT64_MAX;
+};
@@ -0,0 +1,113 @@
+#include "ShaderLibrary.h"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+namespace {
+
+// Generated from shaders/*.wgsl by Makefile.emscripten
+struct BuiltinShader {
+    const char* name;
+    const char* source;
+};
+
+const BuiltinShader BUILTIN_SHADERS[] = {
+    {"galaxy_points",
+#include "galaxy_points.wgsl.inc"
+    },
+    {"galaxy_stats",
+#include "galaxy_stats.wgsl.inc"
+    },
+    {"galaxy_update",
+#include "galaxy_update.wgsl.inc"
+    },
+    {"grid",
+#include "grid.wgsl.inc"
+    },
+    {"triangle",
+#include "triangle.wgsl.inc"
+    },
+    {"ui_composite",
+#include "ui_composite.wgsl.inc"
+    },
+    {"upscale",
+#include "upscale.wgsl.inc"
+    },
+};
+
+} // namespace
+
+ShaderLibrary::ShaderLibrary() {
+    for (const BuiltinShader& builtin : BUILTIN_SHADERS) {
+        shaders[builtin.name].source = builtin.source;
+    }
+    setSearchPath(searchPath);
+}
+
+const std::string& ShaderLibrary::getSource(const std::string& name) const {
+    static const std::string empty;
+    auto it = shaders.find(name);
+    return it != shaders.end() ? it->second.source : empty;
+}
+
+void ShaderLibrary::setSearchPath(const std::string& path) {
+    searchPath = path;
+#ifndef __EMSCRIPTEN__
+    std::error_code ec;
+    watching = std::filesystem::is_directory(searchPath, ec);
+    if (!watching) return;
+
+    for (auto& [name, shader] : shaders) {
+        loadFromFile(name, shader);
+    }
+    printf("Watching shaders in %s\n", searchPath.c_str());
+#endif
+}
+
+bool ShaderLibrary::loadFromFile(const std::string& name, Shader& shader) {
+#ifdef __EMSCRIPTEN__
+    (void)name;
+    (void)shader;
+    return false;
+#else
+    std::filesystem::path path = std::filesystem::path(searchPath) / (name + ".wgsl");
+    std::error_code ec;
+    auto writeTime = std::filesystem::last_write_time(path, ec);
+    if (ec) return false;
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return false;
+    std::stringstream contents;
+    contents << file.rdbuf();
+
+    shader.source = contents.str();
+    shader.lastWriteTime = writeTime;
+    shader.fromFile = true;
+    return true;
+#endif
+}
+
+std::vector<std::string> ShaderLibrary::pollChanges() {
+    std::vector<std::string> changed;
+#ifndef __EMSCRIPTEN__
+    if (!watching) return changed;
+
+    for (auto& [name, shader] : shaders) {
+        std::filesystem::path path = std::filesystem::path(searchPath) / (name + ".wgsl");
+        std::error_code ec;
+        auto writeTime = std::filesystem::last_write_time(path, ec);
+        if (ec || (shader.fromFile && writeTime == shader.lastWriteTime)) continue;
+
+        // Editors often truncate before writing; an empty read is retried on the next poll
+        std::string previous = shader.source;
+        if (loadFromFile(name, shader) && !shader.source.empty() && shader.source != previous) {
+            printf("Shader '%s' changed on disk, recompiling\n", name.c_str());
+            changed.push_back(name);
+        } else if (shader.source.empty()) {
+            shader.source = previous;
+            shader.fromFile = false;
+        }
+    }
+#endif
+    return changed;
+}
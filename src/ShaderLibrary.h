@@ -0,0 +1,42 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#ifndef __EMSCRIPTEN__
+#include <filesystem>
+#endif
+
+// Named WGSL sources. Every shader in shaders/ is embedded at build time; on desktop the
+// library prefers the file on disk and watches it so edits can be recompiled while running.
+class ShaderLibrary {
+public:
+    ShaderLibrary();
+
+    // Returns the current source for a shader, or an empty string if the name is unknown
+    const std::string& getSource(const std::string& name) const;
+
+    // Directory searched for <name>.wgsl overrides (desktop only)
+    void setSearchPath(const std::string& path);
+
+    // Re-reads any watched file whose timestamp changed and returns the names that changed
+    std::vector<std::string> pollChanges();
+
+    bool isWatching() const { return watching; }
+
+private:
+    struct Shader {
+        std::string source;
+#ifndef __EMSCRIPTEN__
+        std::filesystem::file_time_type lastWriteTime{};
+        bool fromFile = false;
+#endif
+    };
+
+    bool loadFromFile(const std::string& name, Shader& shader);
+
+    std::unordered_map<std::string, Shader> shaders;
+    std::string searchPath = "shaders";
+    bool watching = false;
+};
@@ -4,13 +4,20 @@
 #include <glm/gtc/matrix_transform.hpp>
 
 #include "Camera.h"
+#include "PipelineManager.h"
+#include "RenderBundleCache.h"
+#include "BundleRecorder.h"
+#include "GpuHandle.h"
+#include "BufferAllocator.h"
 
 class TriangleRenderer {
 public:
-    TriangleRenderer(WGPUDevice device);
+    TriangleRenderer(WGPUDevice device, PipelineManager& pipelines, BufferAllocator& allocator);
     ~TriangleRenderer();
 
-    void render(WGPURenderPassEncoder renderPass, const Camera& camera);
+    // Updates uniforms and returns the cache holding the draw, queueing a re-record on the recorder
+    // when it is stale; nullptr while the pipeline compiles
+    RenderBundleCache* getRenderBundle(const Camera& camera, BundleRecorder& recorder);
     void update(float deltaTime);  // New update function for rotation
     void cleanup();
 
@@ -22,11 +29,14 @@ private:
     void updateUniformBuffer(const Camera& camera);
 
     WGPUDevice device;
-    WGPURenderPipeline pipeline = nullptr;
-    WGPUBuffer vertexBuffer = nullptr;
-    WGPUBuffer uniformBuffer = nullptr;
-    WGPUBindGroup bindGroup = nullptr;
-    WGPUBindGroupLayout bindGroupLayout = nullptr;
+    PipelineManager& pipelines;
+    BufferAllocator& allocator;
+    PipelineManager::Handle pipeline = PipelineManager::INVALID_HANDLE;
+    BufferAllocation vertexBuffer;
+    BufferAllocation uniformBuffer;
+    GpuBindGroup bindGroup;
+    GpuBindGroupLayout bindGroupLayout;
+    RenderBundleCache bundle;
 
     // Basic vertex data for a triangle
     struct Vertex {
@@ -47,4 +57,6 @@ private:
 
     float rotationAngle = 0.0f;
     UniformData uniformData;
+    uint64_t cameraVersion = UINT64_MAX;  // Camera version last uploaded
+    float uploadedAngle = 0.0f;
 };
\ No newline at end of file
@@ -0,0 +1,108 @@
+#include "UiLayer.h"
+#include <algorithm>
+
+UiLayer::UiLayer(WGPUDevice device, PipelineManager& pipelines, ReleaseQueue& releaseQueue, WGPUTextureFormat format)
+    : device(device), pipelines(pipelines), releaseQueue(releaseQueue), format(format) {
+    WGPUBindGroupLayoutEntry entry = {};
+    entry.binding = 0;
+    entry.visibility = WGPUShaderStage_Fragment;
+    entry.texture.sampleType = WGPUTextureSampleType_Float;
+    entry.texture.viewDimension = WGPUTextureViewDimension_2D;
+
+    WGPUBindGroupLayoutDescriptor bglDesc = {};
+    bglDesc.entryCount = 1;
+    bglDesc.entries = &entry;
+    bindGroupLayout.reset(wgpuDeviceCreateBindGroupLayout(device, &bglDesc));
+
+    RenderPipelineDesc pipelineDesc;
+    pipelineDesc.label = "UI composite";
+    pipelineDesc.shaderName = "ui_composite";
+    pipelineDesc.bindGroupLayouts = {bindGroupLayout.get()};
+    pipelineDesc.colorFormat = format;
+    pipelineDesc.blend.color = {WGPUBlendOperation_Add, WGPUBlendFactor_One, WGPUBlendFactor_OneMinusSrcAlpha};
+    pipelineDesc.blend.alpha = pipelineDesc.blend.color;
+    pipeline = pipelines.requestRenderPipeline(pipelineDesc);
+}
+
+void UiLayer::resize(int width, int height) {
+    width = std::max(width, 1);
+    height = std::max(height, 1);
+    if (width == this->width && height == this->height && texture) return;
+    this->width = width;
+    this->height = height;
+    hasContent = false;
+    if (texture && width <= targetWidth && height <= targetHeight) return;
+
+    targetWidth = width > targetWidth ? std::max(width, targetWidth + targetWidth / 4) : targetWidth;
+    targetHeight = height > targetHeight ? std::max(height, targetHeight + targetHeight / 4) : targetHeight;
+    releaseTarget();
+    createTarget();
+}
+
+void UiLayer::trim() {
+    if (targetWidth == width && targetHeight == height) return;
+    targetWidth = width;
+    targetHeight = height;
+    releaseTarget();
+    createTarget();
+    hasContent = false;
+}
+
+void UiLayer::createTarget() {
+    WGPUTextureDescriptor textureDesc = {};
+    textureDesc.label = "UI layer";
+    textureDesc.usage = WGPUTextureUsage_RenderAttachment | WGPUTextureUsage_TextureBinding;
+    textureDesc.dimension = WGPUTextureDimension_2D;
+    textureDesc.size = {(uint32_t)targetWidth, (uint32_t)targetHeight, 1};
+    textureDesc.format = format;
+    textureDesc.mipLevelCount = 1;
+    textureDesc.sampleCount = 1;
+    texture.reset(wgpuDeviceCreateTexture(device, &textureDesc));
+    view.reset(wgpuTextureCreateView(texture.get(), nullptr));
+
+    WGPUBindGroupEntry entry = {};
+    entry.binding = 0;
+    entry.textureView = view.get();
+
+    WGPUBindGroupDescriptor bgDesc = {};
+    bgDesc.layout = bindGroupLayout.get();
+    bgDesc.entryCount = 1;
+    bgDesc.entries = &entry;
+    bindGroup.reset(wgpuDeviceCreateBindGroup(device, &bgDesc));
+}
+
+void UiLayer::releaseTarget() {
+    // The previous layer may still be in use by frames in flight
+    releaseQueue.retire(std::move(bindGroup));
+    releaseQueue.retire(std::move(view));
+    releaseQueue.retire(std::move(texture));
+}
+
+// MARK: Frame
+
+bool UiLayer::beginFrame(bool hasInput) {
+    auto now = std::chrono::steady_clock::now();
+    if (hasInput) settleFrames = SETTLE_FRAMES;
+
+    // A layer discarded by a resize is re-rendered from the last UI by the render side, so
+    // only the UI's own triggers matter here
+    bool idleExpired = std::chrono::duration<float>(now - lastRedraw).count() >= refreshInterval;
+    if (enabled && settleFrames == 0 && !idleExpired) {
+        reuseCount++;
+        return false;
+    }
+
+    if (settleFrames > 0) settleFrames--;
+    lastRedraw = now;
+    redrawCount++;
+    return true;
+}
+
+void UiLayer::composite(WGPURenderPassEncoder renderPass) {
+    WGPURenderPipeline renderPipeline = pipelines.getRenderPipeline(pipeline);
+    if (!renderPipeline || !hasContent) return;
+
+    wgpuRenderPassEncoderSetPipeline(renderPass, renderPipeline);
+    wgpuRenderPassEncoderSetBindGroup(renderPass, 0, bindGroup.get(), 0, nullptr);
+    wgpuRenderPassEncoderDraw(renderPass, 3, 1, 0, 0);
+}
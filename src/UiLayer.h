@@ -0,0 +1,79 @@
+#pragma once
+#include <webgpu/webgpu.h>
+#include <chrono>
+#include "PipelineManager.h"
+#include "GpuHandle.h"
+#include "ReleaseQueue.h"
+
+// Caches the rendered UI in an offscreen texture and composites it with one fullscreen draw.
+//
+// The UI is only rebuilt and re-rendered when input arrived, the output was resized, someone
+// called invalidate(), or refreshInterval elapsed (so live readouts keep updating, slowly).
+// After each trigger it keeps redrawing for a few frames, since ImGui needs them to settle
+// layouts and hover states. ImGui's blending leaves premultiplied alpha in the layer.
+//
+// beginFrame(), invalidate() and enabled belong to the thread that builds the UI; the layer
+// itself (resize(), trim(), markRendered(), composite()) belongs to the render side.
+class UiLayer {
+public:
+    UiLayer(WGPUDevice device, PipelineManager& pipelines, ReleaseQueue& releaseQueue, WGPUTextureFormat format);
+
+    // Like DynamicResolution, grows the layer with headroom and keeps it while shrinking;
+    // only the top-left output-sized region is drawn to and composited
+    void resize(int width, int height);
+    void trim();
+
+    // Decides whether the UI is rebuilt this frame; call once per frame before ImGui::NewFrame.
+    // Always true while disabled, since the UI is then drawn straight to the output.
+    bool beginFrame(bool hasInput);
+
+    // Forces the UI to be rebuilt on the next frames
+    void invalidate() { settleFrames = SETTLE_FRAMES; }
+
+    // Target for ImGui while the layer is cached; clear it to transparent before drawing
+    WGPUTextureView getView() const { return view.get(); }
+
+    // Call once ImGui has been rendered into the layer; until then composite() draws nothing.
+    // A resize or trim discards the contents, after which the layer is stale until re-rendered.
+    void markRendered() { hasContent = true; }
+    bool isStale() const { return !hasContent; }
+
+    // Whether the composite pipeline has compiled; until it has, draw ImGui to the output directly
+    bool isReady() const { return pipelines.getRenderPipeline(pipeline) != nullptr; }
+
+    // Draws the cached layer over the output pass
+    void composite(WGPURenderPassEncoder renderPass);
+
+    bool enabled = true;
+    float refreshInterval = 0.25f;  // Seconds between redraws while idle
+
+    size_t getRedrawCount() const { return redrawCount; }
+    size_t getReuseCount() const { return reuseCount; }
+
+private:
+    void createTarget();
+    void releaseTarget();
+
+    static constexpr int SETTLE_FRAMES = 3;
+
+    WGPUDevice device;
+    PipelineManager& pipelines;
+    ReleaseQueue& releaseQueue;
+    WGPUTextureFormat format;
+    PipelineManager::Handle pipeline = PipelineManager::INVALID_HANDLE;
+
+    GpuTexture texture;
+    GpuTextureView view;
+    GpuBindGroupLayout bindGroupLayout;
+    GpuBindGroup bindGroup;
+
+    int width = 0;
+    int height = 0;
+    int targetWidth = 0;
+    int targetHeight = 0;
+    int settleFrames = SETTLE_FRAMES;
+    bool hasContent = false;
+    std::chrono::steady_clock::time_point lastRedraw;
+    size_t redrawCount = 0;
+    size_t reuseCount = 0;
+};
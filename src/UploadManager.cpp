@@ -0,0 +1,154 @@
+#include "UploadManager.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+UploadManager::UploadManager(WGPUDevice device, AsyncPump& pump) : device(device), pump(pump) {
+    // Created mapped, so the ring is usable on the first frame without waiting for a callback
+    WGPUBufferDescriptor stagingDesc = {};
+    stagingDesc.label = "Upload staging";
+    stagingDesc.size = STAGING_SIZE;
+    stagingDesc.usage = WGPUBufferUsage_MapWrite | WGPUBufferUsage_CopySrc;
+    stagingDesc.mappedAtCreation = true;
+
+    staging.resize(STAGING_COUNT);
+    for (Staging& entry : staging) {
+        entry.buffer.reset(wgpuDeviceCreateBuffer(device, &stagingDesc));
+    }
+}
+
+UploadManager::~UploadManager() {
+    // Late maps only free their request
+    for (MapRequest* request : outstanding) {
+        request->owner = nullptr;
+    }
+}
+
+void UploadManager::upload(WGPUBuffer dst, uint64_t dstOffset, const void* data, uint64_t size,
+                           std::function<void()> onComplete) {
+    if (dstOffset % 4 != 0 || size % 4 != 0) {
+        printf("UploadManager: offset %llu and size %llu must be multiples of 4\n",
+            (unsigned long long)dstOffset, (unsigned long long)size);
+        return;
+    }
+    if (size == 0) {
+        if (onComplete) onComplete();
+        return;
+    }
+
+    jobs.push_back({{dst}, dstOffset, static_cast<const uint8_t*>(data), nullptr, 4, size, 0, std::move(onComplete)});
+    pendingBytes += size;
+}
+
+void UploadManager::uploadGenerated(std::vector<WGPUBuffer> dsts, uint64_t dstOffset, uint64_t elementSize,
+                                    uint64_t count, Generator generate, std::function<void()> onComplete) {
+    if (dstOffset % 4 != 0 || elementSize % 4 != 0 || elementSize == 0 || elementSize > STAGING_SIZE) {
+        printf("UploadManager: offset %llu must be a multiple of 4 and element size %llu a multiple of 4 up to %llu\n",
+            (unsigned long long)dstOffset, (unsigned long long)elementSize, (unsigned long long)STAGING_SIZE);
+        return;
+    }
+    if (count == 0 || dsts.empty()) {
+        if (onComplete) onComplete();
+        return;
+    }
+
+    uint64_t size = elementSize * count;
+    jobs.push_back({std::move(dsts), dstOffset, nullptr, std::move(generate), elementSize, size, 0, std::move(onComplete)});
+    pendingBytes += size;
+}
+
+void UploadManager::cancel(WGPUBuffer dst) {
+    for (auto it = jobs.begin(); it != jobs.end();) {
+        if (std::find(it->dsts.begin(), it->dsts.end(), dst) != it->dsts.end()) {
+            pendingBytes -= it->size - it->uploaded;
+            it = jobs.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+// MARK: Frame
+
+void UploadManager::encode(WGPUCommandEncoder encoder) {
+    uint64_t budget = bytesPerFrame;
+    std::vector<std::function<void()>> completed;
+
+    for (size_t i = 0; i < staging.size() && !jobs.empty() && budget >= 4; i++) {
+        Staging& entry = staging[i];
+        if (entry.state != StagingState::Ready) continue;
+
+        // Pack chunks of as many jobs as fit into this staging buffer
+        uint8_t* mapped = static_cast<uint8_t*>(wgpuBufferGetMappedRange(entry.buffer.get(), 0, STAGING_SIZE));
+        if (!mapped) continue;
+
+        uint64_t stagingOffset = 0;
+        while (!jobs.empty() && stagingOffset < STAGING_SIZE && budget >= 4) {
+            Job& job = jobs.front();
+            uint64_t chunk = std::min({job.size - job.uploaded, STAGING_SIZE - stagingOffset, budget});
+            chunk -= chunk % job.elementSize;
+            if (chunk == 0) break;  // Not even one element fits in what is left
+
+            if (job.generate) {
+                job.generate(job.uploaded / job.elementSize, chunk / job.elementSize, mapped + stagingOffset);
+            } else {
+                memcpy(mapped + stagingOffset, job.data + job.uploaded, chunk);
+            }
+            for (WGPUBuffer dst : job.dsts) {
+                wgpuCommandEncoderCopyBufferToBuffer(encoder, entry.buffer.get(), stagingOffset,
+                    dst, job.dstOffset + job.uploaded, chunk);
+            }
+
+            job.uploaded += chunk;
+            stagingOffset += chunk;
+            budget -= chunk;
+            pendingBytes -= chunk;
+
+            if (job.uploaded == job.size) {
+                if (job.onComplete) completed.push_back(std::move(job.onComplete));
+                jobs.pop_front();
+            }
+        }
+
+        // Left mapped and ready if nothing fit
+        if (stagingOffset == 0) continue;
+        wgpuBufferUnmap(entry.buffer.get());
+        entry.state = StagingState::Submitted;
+    }
+
+    lastFrameBytes = bytesPerFrame - budget;
+
+    // After the loop, so callbacks may queue further uploads
+    for (std::function<void()>& callback : completed) {
+        callback();
+    }
+}
+
+void UploadManager::endFrame() {
+    for (size_t i = 0; i < staging.size(); i++) {
+        if (staging[i].state != StagingState::Submitted) continue;
+
+        MapRequest* request = new MapRequest{this, i};
+        outstanding.insert(request);
+        staging[i].state = StagingState::Mapping;
+        pump.spawn(mapStaging(pump, staging[i].buffer.get(), request));
+    }
+}
+
+Task<void> UploadManager::mapStaging(AsyncPump& pump, WGPUBuffer buffer, MapRequest* request) {
+    WGPUBufferMapAsyncStatus status = co_await mapAsync(pump, buffer, WGPUMapMode_Write, 0, STAGING_SIZE);
+    if (UploadManager* self = request->owner) {
+        self->outstanding.erase(request);
+        self->onMapped(request->staging, status);
+    }
+    delete request;
+}
+
+void UploadManager::onMapped(size_t index, WGPUBufferMapAsyncStatus status) {
+    if (status == WGPUBufferMapAsyncStatus_Success) {
+        staging[index].state = StagingState::Ready;
+    } else {
+        // Left in Mapping, so the ring shrinks by one instead of writing to an unmapped buffer
+        printf("UploadManager: failed to map staging buffer %zu (status %d)\n", index, (int)status);
+    }
+}
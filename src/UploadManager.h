@@ -0,0 +1,105 @@
+#pragma once
+
+#include <webgpu/webgpu.h>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <unordered_set>
+#include <vector>
+#include "GpuHandle.h"
+#include "GpuAsync.h"
+
+// Streams large uploads into device buffers through a ring of MapWrite staging buffers.
+//
+// Data comes either from caller memory or from a generator that writes straight into the
+// mapped staging buffers, so content produced on the fly never needs a full CPU copy.
+// Uploads are split into chunks of at most one staging buffer and recorded as
+// CopyBufferToBuffer commands by encode(), which spends at most bytesPerFrame per frame,
+// so a multi-hundred-MB load is spread over many frames instead of stalling one.
+// After the frame is submitted, endFrame() asks for each used staging buffer to be mapped
+// again; it rejoins the ring when the async pump resumes the map, which is only after the GPU
+// finished the copy out of it.
+class UploadManager {
+public:
+    UploadManager(WGPUDevice device, AsyncPump& pump);
+    ~UploadManager();
+
+    UploadManager(const UploadManager&) = delete;
+    UploadManager& operator=(const UploadManager&) = delete;
+
+    // Queues size bytes of data for dst at dstOffset. data must stay valid until onComplete
+    // runs or the upload is cancelled; dstOffset and size must be multiples of 4.
+    // onComplete runs once the last chunk is recorded, so commands recorded after it see the data.
+    void upload(WGPUBuffer dst, uint64_t dstOffset, const void* data, uint64_t size,
+                std::function<void()> onComplete = nullptr);
+
+    // Writes count elements, starting at element first of the upload, to out
+    using Generator = std::function<void(uint64_t first, uint64_t count, void* out)>;
+
+    // Like upload(), but count elements of elementSize bytes (a multiple of 4) are produced by
+    // generate into mapped staging memory as space frees up, and each chunk is copied to every
+    // buffer in dsts. Chunks never split an element. Host memory stays at the staging ring
+    // however large the upload is; generate runs inside encode().
+    void uploadGenerated(std::vector<WGPUBuffer> dsts, uint64_t dstOffset, uint64_t elementSize, uint64_t count,
+                         Generator generate, std::function<void()> onComplete = nullptr);
+
+    // Drops every queued upload into dst (including ones shared with other destinations);
+    // call before releasing a buffer with uploads pending
+    void cancel(WGPUBuffer dst);
+
+    // Records this frame's copies; call before any pass that reads the destinations
+    void encode(WGPUCommandEncoder encoder);
+
+    // Remaps the staging buffers used this frame; call after the frame is submitted
+    void endFrame();
+
+    uint64_t bytesPerFrame = 16ull * 1024 * 1024;
+
+    uint64_t getPendingBytes() const { return pendingBytes; }
+    uint64_t getLastFrameBytes() const { return lastFrameBytes; }
+    size_t getPendingCount() const { return jobs.size(); }
+
+private:
+    enum class StagingState {
+        Ready,      // Mapped and free to fill
+        Submitted,  // Copy recorded this frame, waiting for endFrame()
+        Mapping,    // mapStaging() waiting for the map
+    };
+
+    struct Staging {
+        GpuBuffer buffer;
+        StagingState state = StagingState::Ready;
+    };
+
+    struct Job {
+        std::vector<WGPUBuffer> dsts;
+        uint64_t dstOffset;
+        const uint8_t* data;  // nullptr when generated
+        Generator generate;
+        uint64_t elementSize;  // Chunk granularity, 4 for plain data
+        uint64_t size;
+        uint64_t uploaded = 0;
+        std::function<void()> onComplete;
+    };
+
+    // Heap-allocated state shared with a map coroutine, detached on destruction
+    struct MapRequest {
+        UploadManager* owner;
+        size_t staging;
+    };
+
+    static Task<void> mapStaging(AsyncPump& pump, WGPUBuffer buffer, MapRequest* request);
+    void onMapped(size_t index, WGPUBufferMapAsyncStatus status);
+
+    static constexpr size_t STAGING_COUNT = 4;
+    static constexpr uint64_t STAGING_SIZE = 4ull * 1024 * 1024;
+
+    WGPUDevice device;
+    AsyncPump& pump;
+    std::vector<Staging> staging;
+    std::deque<Job> jobs;
+    std::unordered_set<MapRequest*> outstanding;
+
+    uint64_t pendingBytes = 0;
+    uint64_t lastFrameBytes = 0;
+};
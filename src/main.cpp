@@ -12,11 +12,26 @@
 #include "../external/imgui/backends/imgui_impl_glfw.h"
 #include "../external/imgui/backends/imgui_impl_wgpu.h"
 #include "../external/imgui/imgui_internal.h"
-#include "PointWebSystem.h"
-#include "TriangleRenderer.h"
+#include "Scene.h"
 #include "Camera.h"
-#include "GridRenderer.h"
+#include "PipelineManager.h"
+#include "ShaderLibrary.h"
+#include "RenderBundleCache.h"
+#include "DynamicResolution.h"
+#include "ReleaseQueue.h"
+#include "BufferAllocator.h"
+#include "UploadManager.h"
+#include "ReadbackManager.h"
+#include "UiLayer.h"
+#include "BakedFontAtlas.h"
+#include "RenderThread.h"
+#include "JobSystem.h"
+#include "AsyncPump.h"
+#include "GpuAsync.h"
 #include <stdio.h>
+#include <chrono>
+#include <mutex>
+#include <vector>
 
 #ifdef __EMSCRIPTEN__
 #include <emscripten.h>
@@ -44,9 +59,101 @@ static WGPUSwapChain     wgpu_swap_chain = nullptr;
 static int               wgpu_swap_chain_width = 1280;
 static int               wgpu_swap_chain_height = 720;
 
-static std::unique_ptr<PointWebSystem> point_system = nullptr;
-static std::unique_ptr<TriangleRenderer> triangle_renderer = nullptr;
-static std::unique_ptr<GridRenderer> grid_renderer = nullptr;
+static std::unique_ptr<ShaderLibrary> shader_library = nullptr;
+static std::unique_ptr<PipelineManager> pipeline_manager = nullptr;
+static std::unique_ptr<ReleaseQueue> release_queue = nullptr;
+static std::unique_ptr<BufferAllocator> buffer_allocator = nullptr;
+static std::unique_ptr<UploadManager> upload_manager = nullptr;
+static std::unique_ptr<ReadbackManager> readback_manager = nullptr;
+static std::unique_ptr<DynamicResolution> dynamic_resolution = nullptr;
+static std::unique_ptr<UiLayer> ui_layer = nullptr;
+static std::unique_ptr<Scene> scene = nullptr;
+static std::unique_ptr<JobSystem> job_system = nullptr;
+// Resumes coroutines waiting on WebGPU callbacks, once per frame
+static AsyncPump async_pump;
+
+// The engine objects above belong to whichever thread runs RenderFrame(). The UI edits them
+// through engine_settings and ui_commands, which travel in the frame packet, and reads them
+// from the readout that RenderFrame() publishes after each frame.
+static std::unique_ptr<RenderThread> render_thread = nullptr;
+static bool use_render_thread = false;
+// The device synchronizes calls itself, so the render thread can present while the main thread
+// uses it and render bundles can be recorded on worker threads
+static bool device_thread_safe = false;
+
+// MARK: Frame
+// Render side state, only touched by RenderFrame()
+static struct FrameState {
+    // Cold start is measured from here to the first submitted frame and to the last compiled pipeline
+    std::chrono::steady_clock::time_point startupTime = std::chrono::steady_clock::now();
+    bool firstFrameSubmitted = false;
+
+    // CPU time spent encoding the scene draws, averaged over recent frames
+    double sceneEncodeMs = 0.0;
+    size_t sceneBundleCount = 0;
+
+    // Offscreen targets only grow while the window is being resized and are trimmed to size
+    // once it has stayed unchanged for a moment
+    std::chrono::steady_clock::time_point lastResizeTime;
+    bool trimPending = false;
+} frameState;
+
+static constexpr float RESIZE_SETTLE_SECONDS = 0.25f;
+
+// MARK: Engine settings
+// Main thread state, copied into every frame packet
+static EngineSettings engine_settings;
+// Edits made while building the UI, moved into the next frame packet
+static std::vector<std::function<void()>> ui_commands;
+
+// MARK: Readout
+// What the UI shows of the engine: filled in by RenderFrame() after each frame, copied by the
+// main thread before it builds the UI
+struct EngineReadout {
+    size_t pipelineCount = 0;
+    size_t pipelinesPending = 0;
+    size_t pipelineDedupHits = 0;
+    uint64_t pooledBytes = 0;
+    size_t poolHits = 0;
+    size_t poolMisses = 0;
+    size_t pendingReleases = 0;
+    BufferAllocator::Stats allocator = {};
+    size_t uploadsPending = 0;
+    uint64_t uploadPendingBytes = 0;
+    uint64_t uploadLastFrameBytes = 0;
+    size_t readbacksQueued = 0;
+    size_t readbacksInFlight = 0;
+    size_t readbacksCompleted = 0;
+    size_t entityCount = 0;
+    size_t archetypeCount = 0;
+    double sceneEncodeMs = 0.0;
+    size_t sceneBundleCount = 0;
+    size_t bundlesRecorded = 0;
+
+    bool resolutionTimingSupported = false;
+    int sceneWidth = 0;
+    int sceneHeight = 0;
+    float resolutionScale = 1.0f;
+    double sceneGpuMs = 0.0;
+
+    glm::vec3 particleCentroid = glm::vec3(0.0f);
+
+    bool hasGalaxy = false;
+    std::vector<EllipseParams> ellipses;
+    std::vector<uint32_t> ellipsePopulations;
+    size_t regeneratedCount = 0;
+
+    bool hasStatistics = false;
+    size_t summaryCount = 0;
+    GalaxyStatistics::Summary summary;
+    std::vector<float> energyHistory;
+    std::vector<float> angularMomentumHistory;
+    int historyOffset = 0;
+};
+
+static std::mutex readout_mutex;
+static EngineReadout published_readout;  // Guarded by readout_mutex
+static EngineReadout readout;            // Main thread's copy, for the UI being built
 
 // MARK: Camera
 static Camera camera{};
@@ -59,12 +166,19 @@ static struct CameraState {
     float farClip = 1000.0f;
 } cameraState;
 
+// Set by resizes and the camera controls, applied once per frame
+static bool camera_projection_dirty = true;
+
 static bool opt_fullscreen = true;
 static ImGuiDockNodeFlags dockspace_flags = ImGuiDockNodeFlags_None;
 
 // Forward declarations
+static void StartWGPU();
 static bool InitWGPU(GLFWwindow* window);
 static void CreateSwapChain(int width, int height);
+static void RenderFrame(const FramePacket& packet);
+static void ApplySettings(const EngineSettings& settings);
+static void PublishReadout();
 
 
 static void renderCameraControls() {
@@ -97,18 +211,44 @@ static void renderCameraControls() {
         }
 
         if (cameraUpdated) {
-            camera.setPerspectiveProjection(
-                glm::radians(cameraState.fov),
-                cameraState.aspectRatio,
-                cameraState.nearClip,
-                cameraState.farClip
-            );
+            camera_projection_dirty = true;
             camera.setViewYXZ(cameraState.position, cameraState.rotation);
         }
     }
 }
 
 
+// MARK: Galaxy cluster
+static struct ClusterState {
+    int count = 1;
+    float spacing = 12.0f;
+} clusterState;
+
+static void renderGalaxyControls() {
+    if (ImGui::CollapsingHeader("Galaxy Cluster")) {
+        bool clusterUpdated = false;
+
+        // Every galaxy is an instance of the same particle buffer, drawn in one call
+        if (ImGui::SliderInt("Galaxies", &clusterState.count, 1, 4096, "%d", ImGuiSliderFlags_Logarithmic)) {
+            clusterUpdated = true;
+        }
+
+        if (ImGui::SliderFloat("Spacing", &clusterState.spacing, 4.0f, 50.0f)) {
+            clusterUpdated = true;
+        }
+
+        if (clusterUpdated) {
+            ui_commands.push_back([count = clusterState.count, spacing = clusterState.spacing] {
+                scene->removeAll(RenderableKind::Galaxy);
+                for (const GalaxyInstance& galaxy : PointWebSystem::makeCluster(count, spacing)) {
+                    scene->addGalaxy(galaxy.model, galaxy.tint, galaxy.phase);
+                }
+            });
+        }
+    }
+}
+
+
 void createDockspace() {
     // Configure flags
     dockspace_flags = ImGuiDockNodeFlags_PassthruCentralNode;
@@ -159,6 +299,113 @@ void createDockspace() {
 }
 
 
+// MARK: Particle readback
+// Render side state, only touched by RenderFrame()
+static struct ReadbackState {
+    bool pending = false;
+    glm::vec3 centroid = glm::vec3(0.0f);
+} readbackState;
+
+static constexpr uint32_t PARTICLE_SAMPLE_COUNT = 1024;
+
+// Keeps one readback in flight while sampling is on; each result lets the next frame start another
+static void sampleParticles() {
+    if (readbackState.pending) return;
+    readbackState.pending = scene->readParticles(0, PARTICLE_SAMPLE_COUNT,
+        [](const Point* points, uint32_t count) {
+            readbackState.pending = false;
+            if (!points || count == 0) return;
+
+            glm::vec3 sum(0.0f);
+            uint32_t active = 0;
+            for (uint32_t i = 0; i < count; i++) {
+                if (points[i].ellipse == INACTIVE_POINT) continue;
+                sum += glm::vec3(points[i].position[0], points[i].position[1], points[i].position[2]);
+                active++;
+            }
+            if (active > 0) readbackState.centroid = sum / float(active);
+        });
+}
+
+static void renderReadbackControls() {
+    if (ImGui::CollapsingHeader("Particle Readback")) {
+        ImGui::Checkbox("Sample particles", &engine_settings.sampleParticles);
+        ImGui::Text("Centroid of first %u: (%.3f, %.3f, %.3f)", PARTICLE_SAMPLE_COUNT,
+            readout.particleCentroid.x, readout.particleCentroid.y, readout.particleCentroid.z);
+        ImGui::Text("%zu queued, %zu in flight, %zu completed", readout.readbacksQueued,
+            readout.readbacksInFlight, readout.readbacksCompleted);
+    }
+}
+
+// MARK: Galaxy shape
+static int selected_ellipse = 0;
+
+static void renderEllipseControls() {
+    if (ImGui::CollapsingHeader("Galaxy Shape")) {
+        if (!readout.hasGalaxy) {
+            ImGui::TextDisabled("No galaxy simulated");
+            return;
+        }
+
+        ImGui::SliderInt("Ellipse", &selected_ellipse, 0, PointWebSystem::MAX_ELLIPSES - 1);
+
+        // Only the selected ellipse's stars are regenerated and re-uploaded on change
+        EllipseParams params = readout.ellipses[selected_ellipse];
+        int population = (int)readout.ellipsePopulations[selected_ellipse];
+        bool changed = false;
+        changed |= ImGui::SliderFloat("Major axis", &params.majorAxis, 0.5f, 30.0f);
+        changed |= ImGui::SliderFloat("Minor axis", &params.minorAxis, 0.5f, 30.0f);
+        changed |= ImGui::SliderAngle("Tilt", &params.tiltAngle, 0.0f, 360.0f);
+        changed |= ImGui::SliderFloat("Speed", &params.speed, 0.0f, 5.0f);
+        changed |= ImGui::SliderInt("Population", &population, 0, PointWebSystem::ELLIPSE_CAPACITY);
+        if (changed) {
+            ui_commands.push_back([index = selected_ellipse, params, population] {
+                if (PointWebSystem* galaxy = scene->getGalaxySystem())
+                    galaxy->setEllipse(index, params, (uint32_t)population);
+            });
+        }
+        ImGui::Text("%zu stars regenerated by edits", readout.regeneratedCount);
+    }
+}
+
+// MARK: Galaxy statistics
+static void renderStatisticsControls() {
+    if (ImGui::CollapsingHeader("Galaxy Statistics")) {
+        if (!readout.hasStatistics) {
+            ImGui::TextDisabled("No galaxy simulated");
+            return;
+        }
+
+        // Reduced on the GPU each frame; only the summary record comes back
+        ImGui::Checkbox("Compute statistics", &engine_settings.computeStatistics);
+        ImGui::SliderFloat("Profile radius", &engine_settings.histogramRadius, 5.0f, 100.0f, "%.1f");
+        if (readout.summaryCount == 0) {
+            ImGui::TextDisabled("Waiting for first result");
+            return;
+        }
+
+        const GalaxyStatistics::Summary& summary = readout.summary;
+        ImGui::Text("Stars: %u", summary.count);
+        ImGui::Text("Centre of mass: (%.3f, %.3f, %.3f)",
+            summary.centerOfMass.x, summary.centerOfMass.y, summary.centerOfMass.z);
+        ImGui::Text("Bounds: (%.2f, %.2f, %.2f) - (%.2f, %.2f, %.2f)",
+            summary.boundsMin.x, summary.boundsMin.y, summary.boundsMin.z,
+            summary.boundsMax.x, summary.boundsMax.y, summary.boundsMax.z);
+        ImGui::Text("Angular momentum: (%.1f, %.1f, %.1f)",
+            summary.angularMomentum.x, summary.angularMomentum.y, summary.angularMomentum.z);
+        ImGui::Text("Velocity dispersion: (%.3f, %.3f, %.3f)",
+            summary.velocityDispersion.x, summary.velocityDispersion.y, summary.velocityDispersion.z);
+        ImGui::Text("Kinetic energy: %.1f", summary.kineticEnergy);
+
+        ImGui::PlotLines("Kinetic energy", readout.energyHistory.data(), GalaxyStatistics::HISTORY_LENGTH,
+            readout.historyOffset, nullptr, FLT_MAX, FLT_MAX, ImVec2(0, 50));
+        ImGui::PlotLines("|L|", readout.angularMomentumHistory.data(), GalaxyStatistics::HISTORY_LENGTH,
+            readout.historyOffset, nullptr, FLT_MAX, FLT_MAX, ImVec2(0, 50));
+        ImGui::PlotHistogram("Radial profile", summary.radialProfile, GalaxyStatistics::HISTOGRAM_BINS,
+            0, nullptr, 0.0f, FLT_MAX, ImVec2(0, 60));
+    }
+}
+
 static void glfw_error_callback(int error, const char* description)
 {
     printf("GLFW Error %d: %s\n", error, description);
@@ -181,6 +428,18 @@ static void wgpu_error_callback(WGPUErrorType error_type, const char* message, v
 // MARK: Main code
 int main(int, char**)
 {
+    frameState.startupTime = std::chrono::steady_clock::now();
+
+    // ImGui's DeltaTime only advances on frames that rebuild the UI, so the scene keeps its own clock
+    auto last_frame_time = std::chrono::steady_clock::now();
+
+    // Size the camera aspect ratio was last computed for
+    int framebuffer_width = 0;
+    int framebuffer_height = 0;
+
+    // Most recent UI copy handed to the render thread, reused on frames that skip rebuilding the UI
+    std::shared_ptr<UiSnapshot> ui_snapshot;
+
     glfwSetErrorCallback(glfw_error_callback);
     if (!glfwInit())
         return 1;
@@ -192,16 +451,9 @@ int main(int, char**)
     if (window == nullptr)
         return 1;
 
-    // Initialize the WebGPU environment
-    if (!InitWGPU(window))
-    {
-        if (window)
-            glfwDestroyWindow(window);
-        glfwTerminate();
-        return 1;
-    }
-    CreateSwapChain(wgpu_swap_chain_width, wgpu_swap_chain_height);
-    glfwShowWindow(window);
+    // Ask for the device first; everything up to InitWGPU() that does not need it runs while
+    // the request is pending
+    StartWGPU();
 
     // Setup Dear ImGui context
     IMGUI_CHECKVERSION();
@@ -215,17 +467,11 @@ int main(int, char**)
     ImGui::StyleColorsDark();
     // ImGui::StyleColorsLight();
 
-    // Setup Platform/Renderer backends
+    // Setup Platform backend; the renderer backend needs the device
     ImGui_ImplGlfw_InitForOther(window, true);
 #ifdef __EMSCRIPTEN__
     ImGui_ImplGlfw_InstallEmscriptenCallbacks(window, "#canvas");
 #endif
-    ImGui_ImplWGPU_InitInfo init_info;
-    init_info.Device = wgpu_device;
-    init_info.NumFramesInFlight = 3;
-    init_info.RenderTargetFormat = wgpu_preferred_fmt;
-    init_info.DepthStencilFormat = WGPUTextureFormat_Undefined;
-    ImGui_ImplWGPU_Init(&init_info);
 
     // Load Fonts
     // - If no fonts are loaded, dear imgui will use the default font. You can also load multiple fonts and use ImGui::PushFont()/PopFont() to select them.
@@ -247,17 +493,35 @@ int main(int, char**)
     //IM_ASSERT(font != nullptr);
 #endif
 
+    // The default font atlas is baked at build time (tools/bake_font_atlas.cpp); this is a no-op if fonts were added above
+    BakedFontAtlas::load(io.Fonts);
+
+    // Initialize the WebGPU environment
+    if (!InitWGPU(window))
+    {
+        ImGui_ImplGlfw_Shutdown();
+        ImGui::DestroyContext();
+        if (window)
+            glfwDestroyWindow(window);
+        glfwTerminate();
+        return 1;
+    }
+    CreateSwapChain(wgpu_swap_chain_width, wgpu_swap_chain_height);
+    glfwShowWindow(window);
+
+    // Setup Renderer backend
+    ImGui_ImplWGPU_InitInfo init_info;
+    init_info.Device = wgpu_device;
+    init_info.NumFramesInFlight = 3;
+    init_info.RenderTargetFormat = wgpu_preferred_fmt;
+    init_info.DepthStencilFormat = WGPUTextureFormat_Undefined;
+    ImGui_ImplWGPU_Init(&init_info);
+
     // Our state
     bool show_demo_window = false;
     ImVec4 clear_color = ImVec4(0.f, 0.f, 0.f, 1.00f);
 
     // Initialize camera
-    camera.setPerspectiveProjection(
-        glm::radians(cameraState.fov),
-        cameraState.aspectRatio,
-        cameraState.nearClip,
-        cameraState.farClip
-    );
     camera.setViewYXZ(cameraState.position, cameraState.rotation);
 
     // Main loop
@@ -282,110 +546,182 @@ int main(int, char**)
             continue;
         }
 
-        // React to changes in screen size
+        // React to changes in screen size; the render side recreates the swap chain to match
         int width, height;
         glfwGetFramebufferSize((GLFWwindow*)window, &width, &height);
-        if (width != wgpu_swap_chain_width || height != wgpu_swap_chain_height)
+        const bool framebuffer_resized = width > 0 && height > 0 && (width != framebuffer_width || height != framebuffer_height);
+        if (framebuffer_resized)
         {
-            ImGui_ImplWGPU_InvalidateDeviceObjects();
-            CreateSwapChain(width, height);
-            ImGui_ImplWGPU_CreateDeviceObjects();
-
-            // Update camera aspect ratio
+            framebuffer_width = width;
+            framebuffer_height = height;
             cameraState.aspectRatio = float(width) / float(height);
-            camera.setPerspectiveProjection(
-                glm::radians(cameraState.fov),
-                cameraState.aspectRatio,
-                cameraState.nearClip,
-                cameraState.farClip
-            );
+            camera_projection_dirty = true;
         }
 
-        // MARK: ImGui
-        ImGui_ImplWGPU_NewFrame();
-        ImGui_ImplGlfw_NewFrame();
-        ImGui::NewFrame();
+        // Start or stop the render thread between frames; stopping renders what is still queued
+        if (use_render_thread != (render_thread != nullptr))
+        {
+            if (use_render_thread)
+                render_thread = std::make_unique<RenderThread>(RenderFrame);
+            else
+                render_thread.reset();
+            ui_snapshot.reset();
+        }
 
-        createDockspace();
+        FramePacket packet;
 
-        if (show_demo_window)
-            ImGui::ShowDemoWindow(&show_demo_window);
+        // Jobs that need the main thread run here. While the render thread runs they overlap
+        // its frame, so they must leave the engine objects alone.
+        job_system->pumpMainThread();
 
+        // MARK: ImGui
+        // With the UI layer cached, the UI is only rebuilt when something could have changed it.
+        // A resize discards the layer on the render side, so the UI has to be drawn into it again.
+        if (framebuffer_resized)
+            ui_layer->invalidate();
+        const bool ui_has_input = ImGui::GetCurrentContext()->InputEventsQueue.Size > 0;
+        const bool redraw_ui = ui_layer->beginFrame(ui_has_input);
+        if (redraw_ui)
         {
-            ImGui::Begin("Hierarchy");
+            {
+                std::lock_guard<std::mutex> readout_lock(readout_mutex);
+                readout = published_readout;
+            }
 
-            ImGui::Checkbox("Demo Window", &show_demo_window);
+            ImGui_ImplWGPU_NewFrame();
+            ImGui_ImplGlfw_NewFrame();
+            ImGui::NewFrame();
 
-            ImGui::ColorEdit3("clear color", (float*)&clear_color);
-            
-            ImGui::Separator();
-            renderCameraControls();
-            ImGui::Separator();
+            createDockspace();
 
-            ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / io.Framerate, io.Framerate);
-            ImGui::End();
-        }
+            if (show_demo_window)
+                ImGui::ShowDemoWindow(&show_demo_window);
+
+            {
+                ImGui::Begin("Hierarchy");
 
-        // Rendering
-        ImGui::Render();
+                ImGui::Checkbox("Demo Window", &show_demo_window);
 
+                ImGui::ColorEdit3("clear color", (float*)&clear_color);
+            
+                ImGui::Separator();
+                renderCameraControls();
+                renderGalaxyControls();
+                renderReadbackControls();
+                renderStatisticsControls();
+                renderEllipseControls();
+                ImGui::Separator();
+
+                ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / io.Framerate, io.Framerate);
+                ImGui::Text("Pipelines: %zu/%zu ready, %zu deduplicated",
+                    readout.pipelineCount - readout.pipelinesPending, readout.pipelineCount, readout.pipelineDedupHits);
+                ImGui::Text("Buffer pool: %.1f MB idle, %zu hits, %zu misses, %zu pending releases",
+                    readout.pooledBytes / (1024.0 * 1024.0), readout.poolHits, readout.poolMisses, readout.pendingReleases);
+                const BufferAllocator::Stats& allocator_stats = readout.allocator;
+                ImGui::Text("Suballocated: %zu allocations, %.1f/%.1f KB in %zu blocks + %zu dedicated, transient %.1f KB",
+                    allocator_stats.allocationCount, allocator_stats.usedBytes / 1024.0, allocator_stats.reservedBytes / 1024.0,
+                    allocator_stats.blockCount, allocator_stats.dedicatedCount, allocator_stats.transientBytes / 1024.0);
+                ImGui::Text("Uploads: %zu pending (%.1f MB), %.1f MB last frame",
+                    readout.uploadsPending, readout.uploadPendingBytes / (1024.0 * 1024.0),
+                    readout.uploadLastFrameBytes / (1024.0 * 1024.0));
+                ImGui::Text("Entities: %zu in %zu archetypes", readout.entityCount, readout.archetypeCount);
+                ImGui::Text("Scene encode %.3f ms (%zu bundles, %zu recorded)",
+                    readout.sceneEncodeMs, readout.sceneBundleCount, readout.bundlesRecorded);
+                ImGui::Text("Jobs: %d workers, %zu run, %zu stolen",
+                    job_system->getWorkerCount(), job_system->getExecutedCount(), job_system->getStealCount());
+
+                ImGui::Separator();
+                ImGui::BeginDisabled(!readout.resolutionTimingSupported);
+                ImGui::Checkbox("Dynamic resolution", &engine_settings.dynamicResolution);
+                ImGui::EndDisabled();
+                if (!readout.resolutionTimingSupported)
+                    ImGui::SetItemTooltip("Needs a device with timestamp queries");
+                ImGui::SliderFloat("Scene pass budget (ms)", &engine_settings.resolutionBudgetMs, 4.0f, 33.3f, "%.1f");
+                ImGui::SliderFloat("Min scale", &engine_settings.minResolutionScale, 0.25f, 1.0f, "%.2f");
+                ImGui::Text("Scene %dx%d (%.0f%%), scene pass GPU %.2f ms",
+                    readout.sceneWidth, readout.sceneHeight, readout.resolutionScale * 100.0f, readout.sceneGpuMs);
+
+                ImGui::Separator();
+                ImGui::Checkbox("Cache UI layer", &ui_layer->enabled);
+                ImGui::Text("UI redrawn %zu, reused %zu frames", ui_layer->getRedrawCount(), ui_layer->getReuseCount());
 #ifndef __EMSCRIPTEN__
-        // Tick needs to be called in Dawn to display validation errors
-        // wgpuDeviceTick(wgpu_device);
+                ImGui::BeginDisabled(!device_thread_safe);
+                ImGui::Checkbox("Render thread", &use_render_thread);
+                ImGui::EndDisabled();
+                if (!device_thread_safe)
+                    ImGui::SetItemTooltip("Needs a device with implicit synchronization");
+                ImGui::BeginDisabled(!device_thread_safe);
+                ImGui::Checkbox("Parallel bundle encoding", &engine_settings.parallelEncoding);
+                ImGui::EndDisabled();
+                if (render_thread)
+                    ImGui::Text("Main thread waited %.2f ms for the render thread", render_thread->getWaitMs());
 #endif
+                ImGui::End();
+            }
 
-        WGPURenderPassColorAttachment color_attachments = {};
-        color_attachments.depthSlice = WGPU_DEPTH_SLICE_UNDEFINED;
-        color_attachments.loadOp = WGPULoadOp_Clear;
-        color_attachments.storeOp = WGPUStoreOp_Store;
-        color_attachments.clearValue = { clear_color.x * clear_color.w, clear_color.y * clear_color.w, clear_color.z * clear_color.w, clear_color.w };
-        color_attachments.view = wgpuSwapChainGetCurrentTextureView(wgpu_swap_chain);
-
-        WGPURenderPassDescriptor render_pass_desc = {};
-        render_pass_desc.colorAttachmentCount = 1;
-        render_pass_desc.colorAttachments = &color_attachments;
-        render_pass_desc.depthStencilAttachment = nullptr;
-
-        WGPUCommandEncoderDescriptor enc_desc = {};
-        WGPUCommandEncoder encoder = wgpuDeviceCreateCommandEncoder(wgpu_device, &enc_desc);
+            // Keep rebuilding while a widget is dragged or edited, even without fresh input events
+            if (ImGui::IsAnyItemActive())
+                ui_layer->invalidate();
 
-        WGPUComputePassDescriptor computePassDesc = {};
-        WGPUComputePassEncoder computePass = wgpuCommandEncoderBeginComputePass(encoder, &computePassDesc);
-        point_system->compute(computePass);
-        wgpuComputePassEncoderEnd(computePass);
-        wgpuComputePassEncoderRelease(computePass);
-
-        WGPURenderPassEncoder pass = wgpuCommandEncoderBeginRenderPass(encoder, &render_pass_desc);
-
-        // MARK: Render
-        // float deltaTime = ImGui::GetIO().DeltaTime;
-        point_system->render(pass, camera);
-        grid_renderer->render(pass, camera);
-        // triangle_renderer->update(deltaTime);
-        // triangle_renderer->render(pass, camera);
-
-        ImGui_ImplWGPU_RenderDrawData(ImGui::GetDrawData(), pass);
-        wgpuRenderPassEncoderEnd(pass);
-
-        WGPUCommandBufferDescriptor cmd_buffer_desc = {};
-        WGPUCommandBuffer cmd_buffer = wgpuCommandEncoderFinish(encoder, &cmd_buffer_desc);
-        WGPUQueue queue = wgpuDeviceGetQueue(wgpu_device);
-        wgpuQueueSubmit(queue, 1, &cmd_buffer);
+            // Rendering
+            ImGui::Render();
+        }
+        packet.uiRebuilt = redraw_ui;
+        packet.uiCached = ui_layer->enabled;
+        packet.settings = engine_settings;
+        packet.commands = std::move(ui_commands);
+        ui_commands.clear();
+
+        // Resizes and camera edits from this frame update the projection once
+        if (camera_projection_dirty)
+        {
+            camera.setPerspectiveProjection(
+                glm::radians(cameraState.fov),
+                cameraState.aspectRatio,
+                cameraState.nearClip,
+                cameraState.farClip
+            );
+            camera_projection_dirty = false;
+        }
 
-#ifndef __EMSCRIPTEN__
-        wgpuSwapChainPresent(wgpu_swap_chain);
-#endif
+        const auto frame_time = std::chrono::steady_clock::now();
+        packet.camera = camera;
+        packet.framebufferWidth = framebuffer_width;
+        packet.framebufferHeight = framebuffer_height;
+        packet.deltaTime = std::chrono::duration<float>(frame_time - last_frame_time).count();
+        packet.clearColor = clear_color;
+        last_frame_time = frame_time;
 
-        wgpuTextureViewRelease(color_attachments.view);
-        wgpuRenderPassEncoderRelease(pass);
-        wgpuCommandEncoderRelease(encoder);
-        wgpuCommandBufferRelease(cmd_buffer);
+        if (render_thread)
+        {
+            // ImGui reuses its draw lists on the next NewFrame(), so the render thread gets a copy
+            if (redraw_ui || !ui_snapshot)
+                ui_snapshot = std::make_shared<UiSnapshot>(ImGui::GetDrawData());
+            packet.uiSnapshot = ui_snapshot;
+            packet.drawData = ui_snapshot->get();
+            render_thread->submit(std::move(packet));
+        }
+        else
+        {
+            packet.drawData = ImGui::GetDrawData();
+            RenderFrame(packet);
+        }
     }
 #ifdef __EMSCRIPTEN__
     EMSCRIPTEN_MAINLOOP_END;
 #endif
 
-    triangle_renderer.reset();
+    render_thread.reset();
+    job_system.reset();
+    scene.reset();
+    dynamic_resolution.reset();
+    ui_layer.reset();
+    release_queue.reset();
+    buffer_allocator.reset();
+    upload_manager.reset();
+    readback_manager.reset();
+    pipeline_manager.reset();
+    shader_library.reset();
 
     // Cleanup
     ImGui_ImplWGPU_Shutdown();
@@ -398,50 +734,311 @@ int main(int, char**)
     return 0;
 }
 
+// MARK: RenderFrame
+// Updates, encodes, submits and presents one frame. Runs on the render thread when it is
+// enabled, otherwise inline at the end of the main loop.
+static void RenderFrame(const FramePacket& packet)
+{
+#ifndef __EMSCRIPTEN__
+    // Tick needs to be called in Dawn to display validation errors and to deliver async pipeline callbacks
+    wgpuDeviceTick(wgpu_device);
+#endif
+    // Coroutines whose WebGPU callbacks fired continue here, on the side that owns the engine
+    async_pump.run();
+
+    // The UI's edits from this frame
+    for (const std::function<void()>& command : packet.commands)
+        command();
+    ApplySettings(packet.settings);
+
+    // Only size-dependent resources are touched: the swap chain is recreated (ImGui's device
+    // objects do not depend on it) and offscreen targets grow if needed
+    const auto now = std::chrono::steady_clock::now();
+    if (packet.framebufferWidth > 0 && packet.framebufferHeight > 0 &&
+        (packet.framebufferWidth != wgpu_swap_chain_width || packet.framebufferHeight != wgpu_swap_chain_height))
+    {
+        CreateSwapChain(packet.framebufferWidth, packet.framebufferHeight);
+        frameState.lastResizeTime = now;
+        frameState.trimPending = true;
+    }
+    else if (frameState.trimPending && std::chrono::duration<float>(now - frameState.lastResizeTime).count() >= RESIZE_SETTLE_SECONDS)
+    {
+        dynamic_resolution->trim();
+        ui_layer->trim();
+        frameState.trimPending = false;
+    }
+
+    // Swap in pipelines that finished compiling (or hot-reloaded) at the frame boundary
+    pipeline_manager->beginFrame();
+    release_queue->collect();
+    dynamic_resolution->update();
+
+    WGPUCommandEncoderDescriptor enc_desc = {};
+    WGPUCommandEncoder encoder = wgpuDeviceCreateCommandEncoder(wgpu_device, &enc_desc);
+    upload_manager->encode(encoder);
+    readback_manager->encode(encoder);
+
+    WGPUComputePassDescriptor computePassDesc = {};
+    WGPUComputePassEncoder computePass = wgpuCommandEncoderBeginComputePass(encoder, &computePassDesc);
+    scene->update(packet.deltaTime);
+    scene->compute(computePass);
+    wgpuComputePassEncoderEnd(computePass);
+    wgpuComputePassEncoderRelease(computePass);
+
+    // The scene is drawn at the dynamic resolution into an offscreen target...
+    const ImVec4& clear_color = packet.clearColor;
+    WGPURenderPassColorAttachment scene_attachment = {};
+    scene_attachment.depthSlice = WGPU_DEPTH_SLICE_UNDEFINED;
+    scene_attachment.loadOp = WGPULoadOp_Clear;
+    scene_attachment.storeOp = WGPUStoreOp_Store;
+    scene_attachment.clearValue = { clear_color.x * clear_color.w, clear_color.y * clear_color.w, clear_color.z * clear_color.w, clear_color.w };
+    scene_attachment.view = dynamic_resolution->getSceneView();
+
+    WGPURenderPassDescriptor scene_pass_desc = {};
+    scene_pass_desc.colorAttachmentCount = 1;
+    scene_pass_desc.colorAttachments = &scene_attachment;
+    scene_pass_desc.depthStencilAttachment = nullptr;
+    scene_pass_desc.timestampWrites = dynamic_resolution->getTimestampWrites();
+
+    WGPURenderPassEncoder scene_pass = wgpuCommandEncoderBeginRenderPass(encoder, &scene_pass_desc);
+    dynamic_resolution->setSceneViewport(scene_pass);
+
+    // MARK: Render
+    // Static draws are recorded once into render bundles and replayed every frame
+    const auto encode_start = std::chrono::steady_clock::now();
+    static std::vector<WGPURenderBundle> scene_bundles;
+    scene_bundles.clear();
+    scene->collectRenderBundles(packet.camera, scene_bundles);
+    if (!scene_bundles.empty())
+        wgpuRenderPassEncoderExecuteBundles(scene_pass, scene_bundles.size(), scene_bundles.data());
+    frameState.sceneBundleCount = scene_bundles.size();
+    const double encode_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - encode_start).count();
+    frameState.sceneEncodeMs += (encode_ms - frameState.sceneEncodeMs) * 0.05;
+
+    wgpuRenderPassEncoderEnd(scene_pass);
+    wgpuRenderPassEncoderRelease(scene_pass);
+    dynamic_resolution->resolveTimestamps(encoder);
+
+    // The cached UI layer is re-rendered on frames that rebuilt the UI and after a resize
+    // discarded it; until its pipeline is ready ImGui draws straight to the output
+    const bool ui_cached = packet.uiCached && ui_layer->isReady();
+    if (ui_cached && (packet.uiRebuilt || ui_layer->isStale()))
+    {
+        WGPURenderPassColorAttachment ui_attachment = {};
+        ui_attachment.depthSlice = WGPU_DEPTH_SLICE_UNDEFINED;
+        ui_attachment.loadOp = WGPULoadOp_Clear;
+        ui_attachment.storeOp = WGPUStoreOp_Store;
+        ui_attachment.clearValue = { 0.0, 0.0, 0.0, 0.0 };
+        ui_attachment.view = ui_layer->getView();
+
+        WGPURenderPassDescriptor ui_pass_desc = {};
+        ui_pass_desc.colorAttachmentCount = 1;
+        ui_pass_desc.colorAttachments = &ui_attachment;
+
+        WGPURenderPassEncoder ui_pass = wgpuCommandEncoderBeginRenderPass(encoder, &ui_pass_desc);
+        ImGui_ImplWGPU_RenderDrawData(packet.drawData, ui_pass);
+        wgpuRenderPassEncoderEnd(ui_pass);
+        wgpuRenderPassEncoderRelease(ui_pass);
+        ui_layer->markRendered();
+    }
+
+    // ...then upscaled to the swap chain, with ImGui composited on top at native resolution
+    WGPURenderPassColorAttachment color_attachments = {};
+    color_attachments.depthSlice = WGPU_DEPTH_SLICE_UNDEFINED;
+    color_attachments.loadOp = WGPULoadOp_Clear;
+    color_attachments.storeOp = WGPUStoreOp_Store;
+    color_attachments.clearValue = scene_attachment.clearValue;
+    color_attachments.view = wgpuSwapChainGetCurrentTextureView(wgpu_swap_chain);
+
+    WGPURenderPassDescriptor render_pass_desc = {};
+    render_pass_desc.colorAttachmentCount = 1;
+    render_pass_desc.colorAttachments = &color_attachments;
+    render_pass_desc.depthStencilAttachment = nullptr;
+
+    WGPURenderPassEncoder pass = wgpuCommandEncoderBeginRenderPass(encoder, &render_pass_desc);
+    dynamic_resolution->upscale(pass);
+
+    if (ui_cached)
+        ui_layer->composite(pass);
+    else
+        ImGui_ImplWGPU_RenderDrawData(packet.drawData, pass);
+    wgpuRenderPassEncoderEnd(pass);
+
+    WGPUCommandBufferDescriptor cmd_buffer_desc = {};
+    WGPUCommandBuffer cmd_buffer = wgpuCommandEncoderFinish(encoder, &cmd_buffer_desc);
+    WGPUQueue queue = wgpuDeviceGetQueue(wgpu_device);
+    buffer_allocator->flushTransient(queue);
+    wgpuQueueSubmit(queue, 1, &cmd_buffer);
+    release_queue->endFrame(queue);
+    upload_manager->endFrame();
+    readback_manager->endFrame();
+
+    if (!frameState.firstFrameSubmitted) {
+        frameState.firstFrameSubmitted = true;
+        printf("First frame submitted %.1f ms after startup (%zu pipelines still compiling)\n",
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - frameState.startupTime).count(),
+            pipeline_manager->getPendingCount());
+    }
+    PublishReadout();
+
+    // A blocking present only holds up this thread, the UI keeps running
 #ifndef __EMSCRIPTEN__
-static WGPUAdapter RequestAdapter(WGPUInstance instance)
+    wgpuSwapChainPresent(wgpu_swap_chain);
+#endif
+
+    wgpuTextureViewRelease(color_attachments.view);
+    wgpuRenderPassEncoderRelease(pass);
+    wgpuCommandEncoderRelease(encoder);
+    wgpuCommandBufferRelease(cmd_buffer);
+}
+
+// MARK: Settings and readout
+// Hands the UI's settings to the engine objects; runs on the render side
+static void ApplySettings(const EngineSettings& settings)
 {
-    auto onAdapterRequestEnded = [](WGPURequestAdapterStatus status, WGPUAdapter adapter, const char* message, void* pUserData)
+    dynamic_resolution->enabled = settings.dynamicResolution && dynamic_resolution->isTimingSupported();
+    dynamic_resolution->budgetMs = settings.resolutionBudgetMs;
+    dynamic_resolution->minScale = settings.minResolutionScale;
+    scene->setParallelEncoding(settings.parallelEncoding);
+    if (GalaxyStatistics* statistics = scene->getGalaxyStatistics())
     {
-        if (status == WGPURequestAdapterStatus_Success)
-            *(WGPUAdapter*)(pUserData) = adapter;
-        else
-            printf("Could not get WebGPU adapter: %s\n", message);
-};
-    WGPUAdapter adapter;
-    wgpuInstanceRequestAdapter(instance, nullptr, onAdapterRequestEnded, (void*)&adapter);
-    return adapter;
+        statistics->enabled = settings.computeStatistics;
+        statistics->histogramRadius = settings.histogramRadius;
+    }
+    if (settings.sampleParticles)
+        sampleParticles();
 }
 
-static WGPUDevice RequestDevice(WGPUAdapter& adapter)
+// Copies what the UI shows out of the engine objects; runs on the render side
+static void PublishReadout()
 {
-    auto onDeviceRequestEnded = [](WGPURequestDeviceStatus status, WGPUDevice device, const char* message, void* pUserData)
+    std::lock_guard<std::mutex> readout_lock(readout_mutex);
+    EngineReadout& out = published_readout;
+    out.pipelineCount = pipeline_manager->getPipelineCount();
+    out.pipelinesPending = pipeline_manager->getPendingCount();
+    out.pipelineDedupHits = pipeline_manager->getDedupHits();
+    out.pooledBytes = release_queue->getPooledBytes();
+    out.poolHits = release_queue->getPoolHits();
+    out.poolMisses = release_queue->getPoolMisses();
+    out.pendingReleases = release_queue->getPendingCount();
+    out.allocator = buffer_allocator->getStats();
+    out.uploadsPending = upload_manager->getPendingCount();
+    out.uploadPendingBytes = upload_manager->getPendingBytes();
+    out.uploadLastFrameBytes = upload_manager->getLastFrameBytes();
+    out.readbacksQueued = readback_manager->getQueuedCount();
+    out.readbacksInFlight = readback_manager->getInFlightCount();
+    out.readbacksCompleted = readback_manager->getCompletedCount();
+    out.entityCount = scene->getRegistry().getEntityCount();
+    out.archetypeCount = scene->getRegistry().getArchetypeCount();
+    out.sceneEncodeMs = frameState.sceneEncodeMs;
+    out.sceneBundleCount = frameState.sceneBundleCount;
+    out.bundlesRecorded = RenderBundleCache::getRecordCount();
+
+    out.resolutionTimingSupported = dynamic_resolution->isTimingSupported();
+    out.sceneWidth = dynamic_resolution->getSceneWidth();
+    out.sceneHeight = dynamic_resolution->getSceneHeight();
+    out.resolutionScale = dynamic_resolution->getScale();
+    out.sceneGpuMs = dynamic_resolution->getGpuMs();
+
+    out.particleCentroid = readbackState.centroid;
+
+    PointWebSystem* galaxy = scene->getGalaxySystem();
+    out.hasGalaxy = galaxy != nullptr;
+    if (galaxy)
     {
-        if (status == WGPURequestDeviceStatus_Success)
-            *(WGPUDevice*)(pUserData) = device;
-        else
-            printf("Could not get WebGPU device: %s\n", message);
-    };
-    WGPUDevice device;
-    wgpuAdapterRequestDevice(adapter, nullptr, onDeviceRequestEnded, (void*)&device);
-    return device;
+        out.ellipses.resize(PointWebSystem::MAX_ELLIPSES);
+        out.ellipsePopulations.resize(PointWebSystem::MAX_ELLIPSES);
+        for (int i = 0; i < PointWebSystem::MAX_ELLIPSES; i++)
+        {
+            out.ellipses[i] = galaxy->getEllipse(i);
+            out.ellipsePopulations[i] = galaxy->getEllipsePopulation(i);
+        }
+        out.regeneratedCount = galaxy->getRegeneratedCount();
+    }
+
+    // The histories only change when a new summary arrives
+    GalaxyStatistics* statistics = scene->getGalaxyStatistics();
+    out.hasStatistics = statistics != nullptr;
+    if (!statistics)
+        out.summaryCount = 0;
+    else if (statistics->getSummaryCount() != out.summaryCount)
+    {
+        out.summaryCount = statistics->getSummaryCount();
+        out.summary = statistics->getSummary();
+        out.energyHistory.assign(statistics->getEnergyHistory(), statistics->getEnergyHistory() + GalaxyStatistics::HISTORY_LENGTH);
+        out.angularMomentumHistory.assign(statistics->getAngularMomentumHistory(),
+            statistics->getAngularMomentumHistory() + GalaxyStatistics::HISTORY_LENGTH);
+        out.historyOffset = statistics->getHistoryOffset();
+    }
+}
+
+#ifndef __EMSCRIPTEN__
+// Requests an adapter and then a device from it; nullptr if either fails
+static Task<WGPUDevice> RequestDevice(WGPUInstance instance)
+{
+    WGPUAdapter adapter = co_await requestAdapter(async_pump, instance, nullptr);
+    if (!adapter)
+        co_return nullptr;
+
+    // Lets the render thread and the bundle recorders use the device alongside the main thread
+    std::vector<WGPUFeatureName> features;
+    device_thread_safe = wgpuAdapterHasFeature(adapter, WGPUFeatureName_ImplicitDeviceSynchronization);
+    if (device_thread_safe)
+        features.push_back(WGPUFeatureName_ImplicitDeviceSynchronization);
+    // Dynamic resolution times the scene pass with it
+    if (wgpuAdapterHasFeature(adapter, WGPUFeatureName_TimestampQuery))
+        features.push_back(WGPUFeatureName_TimestampQuery);
+
+    WGPUDeviceDescriptor device_desc = {};
+    device_desc.requiredFeatureCount = features.size();
+    device_desc.requiredFeatures = features.data();
+
+    WGPUDevice device = co_await requestDevice(async_pump, adapter, &device_desc);
+    wgpuAdapterRelease(adapter);
+    co_return device;
+}
+
+// Set once the request started by StartWGPU() has finished, successfully or not
+static bool device_request_done = false;
+
+static Task<void> AcquireDevice(WGPUInstance instance)
+{
+    wgpu_device = co_await RequestDevice(instance);
+    device_request_done = true;
 }
 #endif
 
+// MARK: StartWGPU
+// Starts the device request and creates the engine objects that do not need a device
+static void StartWGPU()
+{
+    wgpu_instance = wgpuCreateInstance(nullptr);
+#ifndef __EMSCRIPTEN__
+    async_pump.spawn(AcquireDevice(wgpu_instance));
+#endif
+
+    job_system = std::make_unique<JobSystem>();
+    shader_library = std::make_unique<ShaderLibrary>();
+}
+
 // MARK: InitWGPU
 static bool InitWGPU(GLFWwindow* window)
 {
-    wgpu::Instance instance = wgpuCreateInstance(nullptr);
+    wgpu::Instance instance = wgpu_instance;
 
 #ifdef __EMSCRIPTEN__
     wgpu_device = emscripten_webgpu_get_device();
     if (!wgpu_device)
         return false;
 #else
-    WGPUAdapter adapter = RequestAdapter(instance.Get());
-    if (!adapter)
+    // The rest of startup needs the device, so this is where it waits for StartWGPU()'s request
+    while (!device_request_done)
+    {
+        wgpuInstanceProcessEvents(wgpu_instance);
+        async_pump.run();
+    }
+    if (!wgpu_device)
         return false;
-    wgpu_device = RequestDevice(adapter);
 #endif
 
 #ifdef __EMSCRIPTEN__
@@ -460,26 +1057,36 @@ static bool InitWGPU(GLFWwindow* window)
     wgpu_preferred_fmt = WGPUTextureFormat_BGRA8Unorm;
 #endif
 
-    wgpu_instance = instance.MoveToCHandle();
     wgpu_surface = surface.MoveToCHandle();
 
     wgpuDeviceSetUncapturedErrorCallback(wgpu_device, wgpu_error_callback, nullptr);
 
-    point_system = std::make_unique<PointWebSystem>(wgpu_device);
-    if (!point_system) {
-        printf("Failed to create galaxy system!\n");
-        return false;
-    }
-    triangle_renderer = std::make_unique<TriangleRenderer>(wgpu_device);
-    if (!triangle_renderer) {
-        printf("Failed to create triangle renderer!\n");
-        return false;
-    }
-    grid_renderer = std::make_unique<GridRenderer>(wgpu_device);
-    if (!grid_renderer) {
-        printf("Failed to create grid renderer!\n");
-        return false;
+    pipeline_manager = std::make_unique<PipelineManager>(wgpu_device, *shader_library, async_pump);
+    release_queue = std::make_unique<ReleaseQueue>(wgpu_device);
+    buffer_allocator = std::make_unique<BufferAllocator>(wgpu_device);
+    upload_manager = std::make_unique<UploadManager>(wgpu_device, async_pump);
+    readback_manager = std::make_unique<ReadbackManager>(wgpu_device, async_pump);
+    dynamic_resolution = std::make_unique<DynamicResolution>(wgpu_device, *pipeline_manager, *release_queue,
+                                                             *buffer_allocator, *readback_manager, wgpu_preferred_fmt);
+    ui_layer = std::make_unique<UiLayer>(wgpu_device, *pipeline_manager, *release_queue, wgpu_preferred_fmt);
+
+    // Renderers are created by the scene when the first entity needs them
+    scene = std::make_unique<Scene>(wgpu_device, *pipeline_manager, *release_queue, *buffer_allocator, *upload_manager,
+                                    *readback_manager, *job_system);
+    scene->addGalaxy(glm::mat4(1.0f));
+    scene->addGrid();
+
+    // The UI starts out from the engine's defaults
+    engine_settings.dynamicResolution = dynamic_resolution->enabled;
+    engine_settings.resolutionBudgetMs = dynamic_resolution->budgetMs;
+    engine_settings.minResolutionScale = dynamic_resolution->minScale;
+    engine_settings.parallelEncoding = device_thread_safe;
+    if (GalaxyStatistics* statistics = scene->getGalaxyStatistics())
+    {
+        engine_settings.computeStatistics = statistics->enabled;
+        engine_settings.histogramRadius = statistics->histogramRadius;
     }
+    PublishReadout();
 
     return true;
 }
@@ -497,4 +1104,9 @@ static void CreateSwapChain(int width, int height)
     swap_chain_desc.height = height;
     swap_chain_desc.presentMode = WGPUPresentMode_Fifo;
     wgpu_swap_chain = wgpuDeviceCreateSwapChain(wgpu_device, wgpu_surface, &swap_chain_desc);
+
+    if (dynamic_resolution)
+        dynamic_resolution->resize(width, height);
+    if (ui_layer)
+        ui_layer->resize(width, height);
 }
@@ -0,0 +1,115 @@
+// Bakes the default ImGui font atlas into a C++ include so the app can skip rasterization at startup.
+//
+// Usage: bake_font_atlas <output.inc>
+//
+// The output holds the atlas metrics, the glyph table and the alpha8 pixels run-length encoded as
+// (count, value) byte pairs. src/BakedFontAtlas.cpp consumes it; both must be built against the
+// same ImGui version, which the output records and the loader checks.
+#include "imgui.h"
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+// Round-trips exactly and always forms a valid float literal (13 -> 13.0f)
+static void writeFloat(FILE* file, float value) {
+    char text[32];
+    snprintf(text, sizeof(text), "%.9g", value);
+    fprintf(file, strpbrk(text, ".e") ? "%sf" : "%s.0f", text);
+}
+
+int main(int argc, char** argv) {
+    if (argc != 2) {
+        printf("Usage: %s <output.inc>\n", argv[0]);
+        return 1;
+    }
+
+    // Built exactly as the app would on first use: default flags, default font
+    ImFontAtlas atlas;
+    ImFont* font = atlas.AddFontDefault();
+    unsigned char* pixels = nullptr;
+    int width = 0, height = 0;
+    atlas.GetTexDataAsAlpha8(&pixels, &width, &height);
+    if (!pixels || atlas.PackIdMouseCursors < 0) {
+        printf("Failed to build the font atlas\n");
+        return 1;
+    }
+
+    std::vector<unsigned char> encoded;
+    for (int i = 0, count = width * height; i < count;) {
+        unsigned char value = pixels[i];
+        int run = 1;
+        while (i + run < count && run < 255 && pixels[i + run] == value) run++;
+        encoded.push_back((unsigned char)run);
+        encoded.push_back(value);
+        i += run;
+    }
+
+    FILE* file = fopen(argv[1], "w");
+    if (!file) {
+        printf("Failed to open %s for writing\n", argv[1]);
+        return 1;
+    }
+
+    fprintf(file, "// Generated by tools/bake_font_atlas.cpp, do not edit\n");
+    fprintf(file, "static const int BAKED_IMGUI_VERSION = %d;\n", IMGUI_VERSION_NUM);
+    fprintf(file, "static const int BAKED_ATLAS_FLAGS = %d;\n", atlas.Flags);
+    fprintf(file, "static const int BAKED_ATLAS_WIDTH = %d;\n", width);
+    fprintf(file, "static const int BAKED_ATLAS_HEIGHT = %d;\n", height);
+
+    fprintf(file, "static const float BAKED_FONT_METRICS[3] = {");
+    writeFloat(file, font->FontSize);
+    fprintf(file, ", ");
+    writeFloat(file, font->Ascent);
+    fprintf(file, ", ");
+    writeFloat(file, font->Descent);
+    fprintf(file, "};  // Size, ascent, descent\n");
+
+    fprintf(file, "static const float BAKED_WHITE_PIXEL[2] = {");
+    writeFloat(file, atlas.TexUvWhitePixel.x);
+    fprintf(file, ", ");
+    writeFloat(file, atlas.TexUvWhitePixel.y);
+    fprintf(file, "};\n");
+
+    fprintf(file, "static const float BAKED_UV_LINES[%d][4] = {\n", IM_DRAWLIST_TEX_LINES_WIDTH_MAX + 1);
+    for (const ImVec4& uv : atlas.TexUvLines) {
+        fprintf(file, "    {");
+        writeFloat(file, uv.x);
+        fprintf(file, ", ");
+        writeFloat(file, uv.y);
+        fprintf(file, ", ");
+        writeFloat(file, uv.z);
+        fprintf(file, ", ");
+        writeFloat(file, uv.w);
+        fprintf(file, "},\n");
+    }
+    fprintf(file, "};\n");
+
+    const ImFontAtlasCustomRect* cursors = atlas.GetCustomRectByIndex(atlas.PackIdMouseCursors);
+    fprintf(file, "static const unsigned short BAKED_CURSOR_RECT[4] = {%d, %d, %d, %d};\n",
+            cursors->X, cursors->Y, cursors->Width, cursors->Height);
+
+    // The tab glyph is derived from the space by ImFont::BuildLookupTable, so it is not stored
+    fprintf(file, "static const BakedGlyph BAKED_GLYPHS[] = {\n");
+    for (const ImFontGlyph& glyph : font->Glyphs) {
+        if (glyph.Codepoint == '\t') continue;
+        const float values[9] = {glyph.AdvanceX, glyph.X0, glyph.Y0, glyph.X1, glyph.Y1,
+                                 glyph.U0, glyph.V0, glyph.U1, glyph.V1};
+        fprintf(file, "    {%u", glyph.Codepoint);
+        for (float value : values) {
+            fprintf(file, ", ");
+            writeFloat(file, value);
+        }
+        fprintf(file, "},\n");
+    }
+    fprintf(file, "};\n");
+
+    fprintf(file, "static const unsigned char BAKED_PIXELS_RLE[%zu] = {", encoded.size());
+    for (size_t i = 0; i < encoded.size(); i++) {
+        fprintf(file, i % 24 == 0 ? "\n    %d," : " %d,", encoded[i]);
+    }
+    fprintf(file, "\n};\n");
+
+    fclose(file);
+    printf("Baked %dx%d font atlas, %d glyphs, %zu bytes of pixels\n", width, height, font->Glyphs.Size, encoded.size());
+    return 0;
+}
@@ -0,0 +1,223 @@
+// Bakes the default galaxy preset into a .gxic asset (format in src/GalaxyAsset.h), then loads
+// the file back through GalaxyAsset and checks every point against the generator.
+//
+// Usage: bake_galaxy <output.gxic> [--raw]
+//
+// --raw skips the entropy coder, for comparing sizes or decode times.
+#include "GalaxyAsset.h"
+#include "GalaxyGenerator.h"
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+static constexpr uint32_t CHUNK_POINTS = 16384;  // 512 KiB of points, a few chunks per upload frame
+
+// MARK: rANS encoder
+// Counterpart of GalaxyAsset::decodeRans(): symbols are encoded last to first so they decode
+// first to last, and the output is built backwards
+
+static void normalizeFrequencies(const std::vector<uint8_t>& raw, uint16_t freqs[256]) {
+    constexpr int total = 1 << GalaxyAsset::RANS_SCALE_BITS;
+    uint64_t counts[256] = {};
+    for (uint8_t symbol : raw) counts[symbol]++;
+
+    int sum = 0;
+    for (int symbol = 0; symbol < 256; symbol++) {
+        freqs[symbol] = counts[symbol] ? (uint16_t)std::max<uint64_t>(1, counts[symbol] * total / raw.size()) : 0;
+        sum += freqs[symbol];
+    }
+    // Settle rounding on the most frequent symbols, never dropping a present symbol to zero
+    while (sum != total) {
+        int best = -1;
+        for (int symbol = 0; symbol < 256; symbol++) {
+            if (freqs[symbol] == 0 || (sum > total && freqs[symbol] == 1)) continue;
+            if (best < 0 || freqs[symbol] > freqs[best]) best = symbol;
+        }
+        int step = sum < total ? 1 : -1;
+        freqs[best] += step;
+        sum += step;
+    }
+}
+
+static std::vector<uint8_t> encodeRans(const std::vector<uint8_t>& raw) {
+    uint16_t freqs[256];
+    uint32_t starts[256];
+    normalizeFrequencies(raw, freqs);
+    uint32_t start = 0;
+    for (int symbol = 0; symbol < 256; symbol++) {
+        starts[symbol] = start;
+        start += freqs[symbol];
+    }
+
+    std::vector<uint8_t> reversed;
+    uint32_t state = GalaxyAsset::RANS_L;
+    for (size_t i = raw.size(); i-- > 0;) {
+        uint32_t freq = freqs[raw[i]];
+        uint32_t limit = ((GalaxyAsset::RANS_L >> GalaxyAsset::RANS_SCALE_BITS) << 8) * freq;
+        while (state >= limit) {
+            reversed.push_back(uint8_t(state));
+            state >>= 8;
+        }
+        state = ((state / freq) << GalaxyAsset::RANS_SCALE_BITS) + (state % freq) + starts[raw[i]];
+    }
+    for (int shift = 24; shift >= 0; shift -= 8) {
+        reversed.push_back(uint8_t(state >> shift));
+    }
+
+    std::vector<uint8_t> out(sizeof(freqs) + reversed.size());
+    memcpy(out.data(), freqs, sizeof(freqs));
+    std::reverse_copy(reversed.begin(), reversed.end(), out.begin() + sizeof(freqs));
+    return out;
+}
+
+// MARK: Chunks
+
+static GalaxyAssetChunk measureChunk(const Point* points, uint32_t count) {
+    GalaxyAssetChunk chunk = {};
+    chunk.pointCount = count;
+    bool any = false;
+    for (uint32_t i = 0; i < count; i++) {
+        const Point& point = points[i];
+        if (point.ellipse == INACTIVE_POINT) continue;
+        for (int axis = 0; axis < 3; axis++) {
+            if (!any || point.position[axis] < chunk.positionMin[axis]) chunk.positionMin[axis] = point.position[axis];
+            if (!any || point.position[axis] > chunk.positionMax[axis]) chunk.positionMax[axis] = point.position[axis];
+            if (!any || point.velocity[axis] < chunk.velocityMin[axis]) chunk.velocityMin[axis] = point.velocity[axis];
+            if (!any || point.velocity[axis] > chunk.velocityMax[axis]) chunk.velocityMax[axis] = point.velocity[axis];
+        }
+        any = true;
+    }
+    return chunk;
+}
+
+static std::vector<uint8_t> packChunk(const Point* points, const GalaxyAssetChunk& chunk) {
+    uint32_t n = chunk.pointCount;
+    std::vector<uint8_t> raw(size_t(n) * GalaxyAsset::BYTES_PER_POINT);
+    uint16_t previous[GalaxyAsset::FIELD_COUNT] = {};
+    for (uint32_t i = 0; i < n; i++) {
+        const Point& point = points[i];
+        bool active = point.ellipse != INACTIVE_POINT;
+        raw[i] = active ? uint8_t(point.ellipse) : GalaxyAsset::ASSET_INACTIVE;
+
+        for (int field = 0; field < GalaxyAsset::FIELD_COUNT; field++) {
+            int axis = field % 3;
+            uint16_t value = previous[field];
+            if (active) {
+                value = field < 3 ? GalaxyAsset::quantize(point.position[axis], chunk.positionMin[axis], chunk.positionMax[axis])
+                                  : GalaxyAsset::quantize(point.velocity[axis], chunk.velocityMin[axis], chunk.velocityMax[axis]);
+            }
+            uint16_t delta = uint16_t(value - previous[field]);
+            previous[field] = value;
+            uint8_t* lo = raw.data() + n + size_t(field) * 2 * n;
+            lo[i] = uint8_t(delta);
+            lo[n + i] = uint8_t(delta >> 8);
+        }
+    }
+    return raw;
+}
+
+// MARK: Verification
+
+static bool verify(const char* path, const std::vector<Point>& points) {
+    bool ok = true;
+    float maxError[GalaxyAsset::FIELD_COUNT] = {};
+    std::vector<Point> decoded;
+
+    GalaxyAsset::Callbacks callbacks;
+    GalaxyAsset* asset = nullptr;
+    callbacks.onHeader = [](const GalaxyAsset&) { return true; };
+    callbacks.onChunk = [&](uint32_t chunkIndex) {
+        const GalaxyAssetChunk& chunk = asset->getChunk(chunkIndex);
+        const Point* expected = points.data() + size_t(chunkIndex) * asset->getHeader().chunkPoints;
+        decoded.resize(chunk.pointCount);
+        if (!asset->decode(chunkIndex, 0, chunk.pointCount, decoded.data())) {
+            printf("chunk %u failed to decode\n", chunkIndex);
+            ok = false;
+            return;
+        }
+        for (uint32_t i = 0; i < chunk.pointCount; i++) {
+            if (decoded[i].ellipse != expected[i].ellipse) ok = false;
+            for (int axis = 0; axis < 3; axis++) {
+                maxError[axis] = std::max(maxError[axis], std::fabs(decoded[i].position[axis] - expected[i].position[axis]));
+                maxError[3 + axis] = std::max(maxError[3 + axis], std::fabs(decoded[i].velocity[axis] - expected[i].velocity[axis]));
+            }
+        }
+    };
+    callbacks.onFailed = [&](const char*) { ok = false; };
+
+    GalaxyAsset loaded(callbacks);
+    asset = &loaded;
+    loaded.load(path);
+
+    printf("max error: position %g %g %g, velocity %g %g %g\n", maxError[0], maxError[1], maxError[2],
+           maxError[3], maxError[4], maxError[5]);
+    if (!ok) printf("verification FAILED\n");
+    return ok;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        printf("Usage: %s <output.gxic> [--raw]\n", argv[0]);
+        return 1;
+    }
+    const char* path = argv[1];
+    bool entropyCoded = !(argc > 2 && strcmp(argv[2], "--raw") == 0);
+
+    std::vector<EllipseParams> ellipses;
+    std::vector<uint32_t> populations;
+    GalaxyGenerator::initEllipses(ellipses, populations);
+    std::vector<Point> points(GalaxyGenerator::POINT_CAPACITY);
+    for (int i = 0; i < GalaxyGenerator::POINT_CAPACITY; i++) {
+        points[i] = GalaxyGenerator::generatePoint(i, ellipses.data(), populations.data());
+    }
+
+    GalaxyAssetHeader header = {};
+    memcpy(header.magic, GalaxyAsset::ASSET_MAGIC, sizeof(header.magic));
+    header.version = GalaxyAsset::ASSET_VERSION;
+    header.flags = entropyCoded ? GalaxyAsset::ASSET_ENTROPY_CODED : 0;
+    header.pointCount = GalaxyGenerator::POINT_CAPACITY;
+    header.chunkPoints = CHUNK_POINTS;
+    header.chunkCount = (header.pointCount + CHUNK_POINTS - 1) / CHUNK_POINTS;
+    header.ellipseCount = GalaxyGenerator::MAX_ELLIPSES;
+    header.ellipseCapacity = GalaxyGenerator::ELLIPSE_CAPACITY;
+    static_assert(GalaxyGenerator::MAX_ELLIPSES < GalaxyAsset::ASSET_INACTIVE, "ellipse indices are stored in a byte");
+
+    std::vector<GalaxyAssetChunk> chunks(header.chunkCount);
+    std::vector<std::vector<uint8_t>> payloads(header.chunkCount);
+    uint64_t offset = sizeof(header) + header.ellipseCount * (sizeof(EllipseParams) + sizeof(uint32_t)) +
+                      header.chunkCount * sizeof(GalaxyAssetChunk);
+    for (uint32_t c = 0; c < header.chunkCount; c++) {
+        const Point* first = points.data() + size_t(c) * CHUNK_POINTS;
+        chunks[c] = measureChunk(first, std::min(CHUNK_POINTS, header.pointCount - c * CHUNK_POINTS));
+        payloads[c] = packChunk(first, chunks[c]);
+        if (entropyCoded) payloads[c] = encodeRans(payloads[c]);
+        chunks[c].offset = offset;
+        chunks[c].size = (uint32_t)payloads[c].size();
+        offset += payloads[c].size();
+    }
+
+    FILE* file = fopen(path, "wb");
+    if (!file) {
+        printf("Failed to open %s for writing\n", path);
+        return 1;
+    }
+    fwrite(&header, sizeof(header), 1, file);
+    fwrite(ellipses.data(), sizeof(EllipseParams), ellipses.size(), file);
+    fwrite(populations.data(), sizeof(uint32_t), populations.size(), file);
+    fwrite(chunks.data(), sizeof(GalaxyAssetChunk), chunks.size(), file);
+    for (const std::vector<uint8_t>& payload : payloads) {
+        fwrite(payload.data(), 1, payload.size(), file);
+    }
+    if (fclose(file) != 0) {
+        printf("Failed to write %s\n", path);
+        return 1;
+    }
+
+    uint64_t pointBytes = uint64_t(header.pointCount) * sizeof(Point);
+    printf("%s: %u points in %u chunks, %llu bytes (%.1fx smaller than the %llu-byte buffer)%s\n", path,
+           header.pointCount, header.chunkCount, (unsigned long long)offset, double(pointBytes) / offset,
+           (unsigned long long)pointBytes, entropyCoded ? "" : ", not entropy coded");
+    return verify(path, points) ? 0 : 1;
+}
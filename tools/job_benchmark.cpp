@@ -0,0 +1,109 @@
+// Measures the scheduling overhead of src/JobSystem.cpp on the host.
+//
+// Usage: job_benchmark [workers]
+//
+// Every job is empty or nearly so, so the times are the cost of creating, queueing, stealing
+// and retiring a job rather than of any work. Each scenario also checks that every job ran.
+#include "JobSystem.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <atomic>
+#include <chrono>
+
+static constexpr int JOB_COUNT = 200000;
+static constexpr int REPEATS = 5;
+
+template <typename Function>
+static double bestNsPerJob(int jobCount, Function&& function) {
+    double best = 1e30;
+    for (int repeat = 0; repeat < REPEATS; repeat++) {
+        auto start = std::chrono::steady_clock::now();
+        function();
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        if (ns < best) best = ns;
+    }
+    return best / jobCount;
+}
+
+static bool report(const char* name, double nsPerJob, long expected, long actual) {
+    printf("  %-34s %8.1f ns/job%s\n", name, nsPerJob, expected == actual ? "" : "  MISMATCH");
+    return expected == actual;
+}
+
+int main(int argc, char** argv) {
+    int workerCount = argc > 1 ? atoi(argv[1]) : -1;
+    JobSystem jobs(workerCount);
+    printf("%d workers + main thread, best of %d runs\n", jobs.getWorkerCount(), REPEATS);
+
+    bool ok = true;
+    std::atomic<long> ran{0};
+
+    // Fan-out: the main thread queues everything, then helps while waiting
+    ran = 0;
+    double fanOut = bestNsPerJob(JOB_COUNT, [&] {
+        JobCounter counter;
+        for (int i = 0; i < JOB_COUNT; i++) {
+            jobs.run([&] { ran.fetch_add(1, std::memory_order_relaxed); }, &counter);
+        }
+        jobs.wait(counter);
+    });
+    ok &= report("run + wait (fan-out)", fanOut, (long)JOB_COUNT * REPEATS, ran);
+
+    // Nested: a few jobs each spawn many, so most work starts on workers' own deques
+    ran = 0;
+    const int parents = 64, children = JOB_COUNT / parents;
+    double nested = bestNsPerJob(parents * (children + 1), [&] {
+        JobCounter counter;
+        for (int p = 0; p < parents; p++) {
+            jobs.run([&] {
+                JobCounter childCounter;
+                for (int c = 0; c < children; c++) {
+                    jobs.run([&] { ran.fetch_add(1, std::memory_order_relaxed); }, &childCounter);
+                }
+                jobs.wait(childCounter);
+            }, &counter);
+        }
+        jobs.wait(counter);
+    });
+    ok &= report("nested spawn", nested, (long)parents * children * REPEATS, ran);
+
+    // Chain: every job starts after the previous one, the worst case for parallelism
+    ran = 0;
+    const int chainLength = JOB_COUNT / 10;
+    double chain = bestNsPerJob(chainLength, [&] {
+        std::vector<JobCounter> counters(chainLength);
+        jobs.run([&] { ran.fetch_add(1, std::memory_order_relaxed); }, &counters[0]);
+        for (int i = 1; i < chainLength; i++) {
+            jobs.runAfter(counters[i - 1], [&] { ran.fetch_add(1, std::memory_order_relaxed); }, &counters[i]);
+        }
+        jobs.wait(counters[chainLength - 1]);
+    });
+    ok &= report("runAfter chain", chain, (long)chainLength * REPEATS, ran);
+
+    // parallelFor with one item per chunk, the finest split it allows
+    ran = 0;
+    double parallelFor = bestNsPerJob(JOB_COUNT, [&] {
+        jobs.parallelFor(0, JOB_COUNT, 1, [&](size_t begin, size_t end) {
+            ran.fetch_add((long)(end - begin), std::memory_order_relaxed);
+        });
+    });
+    ok &= report("parallelFor, grain 1", parallelFor, (long)JOB_COUNT * REPEATS, ran);
+
+    // Main-thread jobs queued from workers and drained by the main thread's wait
+    ran = 0;
+    double mainThread = bestNsPerJob(JOB_COUNT, [&] {
+        JobCounter counter;
+        jobs.parallelFor(0, JOB_COUNT, 1024, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                jobs.runOnMainThread([&] {
+                    if (jobs.isMainThread()) ran.fetch_add(1, std::memory_order_relaxed);
+                }, &counter);
+            }
+        });
+        jobs.wait(counter);
+    });
+    ok &= report("runOnMainThread from workers", mainThread, (long)JOB_COUNT * REPEATS, ran);
+
+    printf("%zu jobs executed, %zu stolen\n", jobs.getExecutedCount(), jobs.getStealCount());
+    return ok ? 0 : 1;
+}